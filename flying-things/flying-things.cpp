@@ -52,15 +52,6 @@ bool FlyingThings::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // Framebuffer object
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _fboDepthTex, 0);
-
     // VAOs and associated buffers
     for (int i = 0; i < 4; i++) {
         glGenVertexArrays(18, _vaos[i]);
@@ -114,24 +105,15 @@ static float frand() // return random number in [0,1]
 
 void FlyingThings::render(QVRWindow* /* w */,
         const QVRRenderContext& context,
-        const unsigned int* textures)
+        const unsigned int* /* textures */)
 {
     // Initialize random number generator to fixed value so that all processes
     // will generate the same pseudo random number sequence for all frames.
     qsrand(42);
 
     for (int view = 0; view < context.viewCount(); view++) {
-        // Get view dimensions
-        int width = context.textureSize(view).width();
-        int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height,
-                0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
-        // Set up view
-        glViewport(0, 0, width, height);
+        // Set up framebuffer object and view
+        context.bindView(view);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         QMatrix4x4 projectionMatrix = context.frustum(view).toMatrix4x4();
         QMatrix4x4 viewMatrix = context.viewMatrix(view);
@@ -211,6 +193,7 @@ void FlyingThings::render(QVRWindow* /* w */,
                 glDrawElements(GL_TRIANGLES, _vaoIndices[type][lod], GL_UNSIGNED_INT, 0);
             }
         }
+        context.finishView();
     }
 }
 
@@ -40,8 +40,6 @@ private:
     QElapsedTimer _timer;       // used for rotating the box
 
     /* Static data for rendering, initialized per process. */
-    unsigned int _fbo;          // Framebuffer object to render into
-    unsigned int _fboDepthTex;  // Depth attachment for the FBO
     unsigned int _vaos[4][18];  // Vertex array objects for 4 objects in 18 LODs
     unsigned int _vaoIndices[4][18];// Number of indices to render for each VAO
     QOpenGLShaderProgram _prg;  // Shader program for rendering
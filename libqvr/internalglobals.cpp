@@ -89,6 +89,9 @@ QQueue<QVREvent>* QVREventQueue = NULL;
 /* Global timer */
 QElapsedTimer QVRTimer;
 
+/* Global render target pool */
+QVRRenderTargetPool* QVRRenderTargets = NULL;
+
 /* Global renderable device model data */
 QList<QVector<float>> QVRDeviceModelVertexPositions;
 QList<QVector<float>> QVRDeviceModelVertexNormals;
@@ -37,6 +37,7 @@
 
 #include "event.hpp"
 class QVRManager;
+class QVRRenderTargetPool;
 
 
 /* Global manager instance (singleton) */
@@ -58,6 +59,9 @@ extern QQueue<QVREvent>* QVREventQueue;
 /* Global timer */
 extern QElapsedTimer QVRTimer;
 
+/* Global render target pool, created on first use in the master context */
+extern QVRRenderTargetPool* QVRRenderTargets;
+
 /* Global renderable device model data */
 extern QList<QVector<float>> QVRDeviceModelVertexPositions;
 extern QList<QVector<float>> QVRDeviceModelVertexNormals;
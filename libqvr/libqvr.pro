@@ -43,7 +43,8 @@ SOURCES += \
 	logging.cpp \
 	event.cpp \
 	rendercontext.cpp \
-	frustum.cpp
+	frustum.cpp \
+	rendertargetpool.cpp
 
 HEADERS += \
 	manager.hpp \
@@ -57,7 +58,8 @@ HEADERS += \
 	logging.hpp \
 	event.hpp \
 	rendercontext.hpp \
-	frustum.hpp
+	frustum.hpp \
+	rendertargetpool.hpp
 
 RESOURCES += qvr.qrc
 
@@ -42,6 +42,7 @@
 #include "process.hpp"
 #include "ipc.hpp"
 #include "internalglobals.hpp"
+#include "rendertargetpool.hpp"
 
 
 static bool parseLogLevel(const QString& ll, QVRLogLevel* logLevel)
@@ -1029,6 +1030,8 @@ void QVRManager::quit()
     }
     QVR_DEBUG("... exiting process");
     _app->exitProcess(_thisProcess);
+    delete QVRRenderTargets;
+    QVRRenderTargets = NULL;
     _masterWindow->close();
     QTimer::singleShot(0, QGuiApplication::instance(), SLOT(quit()));
     QVR_DEBUG("... quitting process %d done", _thisProcess->index());
@@ -1147,6 +1150,8 @@ void QVRManager::render()
     }
     QVR_FIREHOSE("  ... postRenderProcess()");
     _app->postRenderProcess(_thisProcess);
+    if (QVRRenderTargets)
+        QVRRenderTargets->endFrame();
     /* At this point, we must make sure that all textures actually contain
      * the current scene, otherwise artefacts are displayed when the window
      * threads render them. It seems that glFlush() is not enough for all
@@ -24,6 +24,7 @@
 #include <QDataStream>
 
 #include "rendercontext.hpp"
+#include "rendertargetpool.hpp"
 #include "internalglobals.hpp"
 
 
@@ -45,7 +46,9 @@ QVRRenderContext::QVRRenderContext() :
     _viewMatrix { QMatrix4x4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f),
                   QMatrix4x4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f) },
     _viewMatrixPure { QMatrix4x4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f),
-                  QMatrix4x4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f) }
+                  QMatrix4x4(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f) },
+    _texture { 0, 0 },
+    _textureFormat { 0, 0 }
 {
 }
 
@@ -79,6 +82,21 @@ void QVRRenderContext::setOutputConf(QVROutputMode om)
     }
 }
 
+void QVRRenderContext::bindView(int view, int samples) const
+{
+    Q_ASSERT(view >= 0 && view < viewCount());
+    Q_ASSERT(_texture[view] != 0);
+    if (!QVRRenderTargets)
+        QVRRenderTargets = new QVRRenderTargetPool;
+    QVRRenderTargets->bind(_texture[view], _textureSize[view], _textureFormat[view], samples);
+}
+
+void QVRRenderContext::finishView() const
+{
+    if (QVRRenderTargets)
+        QVRRenderTargets->finish();
+}
+
 QDataStream &operator<<(QDataStream& ds, const QVRRenderContext& rc)
 {
     ds << rc._processIndex << rc._windowIndex
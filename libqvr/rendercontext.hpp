@@ -71,6 +71,9 @@ private:
     QVRFrustum _frustum[2];
     QMatrix4x4 _viewMatrix[2];
     QMatrix4x4 _viewMatrixPure[2];
+    // Process-local, not serialized:
+    unsigned int _texture[2];
+    unsigned int _textureFormat[2];
 
     friend QDataStream &operator<<(QDataStream& ds, const QVRRenderContext& rc);
     friend QDataStream &operator>>(QDataStream& ds, QVRRenderContext& rc);
@@ -86,6 +89,7 @@ private:
     { _screenWall[0] = bl; _screenWall[1]= br; _screenWall[2] = tl; }
     void setOutputConf(QVROutputMode om);
     void setTextureSize(int vp, const QSize& size) { _textureSize[vp] = size; }
+    void setTexture(int vp, unsigned int tex, unsigned int format) { _texture[vp] = tex; _textureFormat[vp] = format; }
     void setTracking(int vp, const QVector3D& p, const QQuaternion& r) { _trackingPosition[vp] = p; _trackingOrientation[vp] = r; }
     void setFrustum(int vp, const QVRFrustum f) { _frustum[vp] = f; }
     void setViewMatrix(int vp, const QMatrix4x4& vm) { _viewMatrix[vp] = vm; }
@@ -123,6 +127,8 @@ public:
     QVREye eye(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _eye[view]; }
     /*! \brief Returns the texture size for rendering \a view. */
     QSize textureSize(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _textureSize[view]; }
+    /*! \brief Returns the internal format of the texture for rendering \a view (GL_SRGB8_ALPHA8 unless the output needs linear textures). */
+    unsigned int textureFormat(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _textureFormat[view]; }
     /*! \brief Returns the observer tracking position for rendering \a view. */
     const QVector3D& trackingPosition(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _trackingPosition[view]; }
     /*! \brief Returns the observer tracking orientation for rendering \a view. */
@@ -135,6 +141,28 @@ public:
     const QMatrix4x4& viewMatrix(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _viewMatrix[view]; }
     /*! \brief Returns the pure view matrix (i.e. in tracking space, without navigation) for rendering \a view. */
     const QMatrix4x4& viewMatrixPure(int view) const { Q_ASSERT(view >= 0 && view < viewCount()); return _viewMatrixPure[view]; }
+
+    /*!
+     * \brief Binds a framebuffer object for rendering \a view and sets the viewport.
+     * \param view         The view
+     * \param samples      Number of samples for multisampling, or 0
+     *
+     * The framebuffer object comes from a pool managed by QVR, keyed by texture size,
+     * texture format and sample count, so nothing is allocated or resized from frame to
+     * frame. Its color attachment is the texture of \a view (or, with \a samples > 0,
+     * a multisample renderbuffer that \a finishView() resolves into that texture), and it
+     * has a 24 bit depth attachment. Call \a finishView() when \a view is done.
+     *
+     * This function may only be called from \a QVRApp::render().
+     */
+    void bindView(int view, int samples = 0) const;
+    /*!
+     * \brief Finishes rendering the view bound with \a bindView().
+     *
+     * Resolves multisampling into the view texture, lets the driver discard the depth
+     * buffer, and unbinds the framebuffer object.
+     */
+    void finishView() const;
 };
 
 QDataStream &operator<<(QDataStream& ds, const QVRRenderContext& rc);
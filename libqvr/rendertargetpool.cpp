@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 Computer Graphics Group, University of Siegen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include "rendertargetpool.hpp"
+#include "manager.hpp"
+#include "logging.hpp"
+
+/* Frames a target may go unused before it is deleted, e.g. after a window
+ * was resized */
+static const int QVRRenderTargetMaxUnusedFrames = 60;
+
+QVRRenderTargetPool::QVRRenderTargetPool() :
+    _gl(QOpenGLContext::currentContext()->extraFunctions()),
+    _maxSamples(0),
+    _current(-1),
+    _currentTexture(0)
+{
+    _gl->glGetIntegerv(GL_MAX_SAMPLES, &_maxSamples);
+}
+
+QVRRenderTargetPool::~QVRRenderTargetPool()
+{
+    for (int i = 0; i < _targets.size(); i++)
+        destroy(_targets[i]);
+}
+
+void QVRRenderTargetPool::destroy(const Target& t)
+{
+    _gl->glDeleteFramebuffers(1, &t.fbo);
+    _gl->glDeleteRenderbuffers(1, &t.depthRb);
+    if (t.samples > 0) {
+        _gl->glDeleteRenderbuffers(1, &t.colorRb);
+        _gl->glDeleteFramebuffers(1, &t.resolveFbo);
+    }
+}
+
+int QVRRenderTargetPool::target(const QSize& size, unsigned int format, int samples)
+{
+    for (int i = 0; i < _targets.size(); i++) {
+        const Target& t = _targets[i];
+        if (t.size == size && t.format == format && t.samples == samples)
+            return i;
+    }
+
+    QVR_DEBUG("creating render target %dx%d, format 0x%x, %d samples",
+            size.width(), size.height(), format, samples);
+    Target t;
+    t.size = size;
+    t.format = format;
+    t.samples = samples;
+    t.colorRb = 0;
+    t.resolveFbo = 0;
+    t.unusedFrames = 0;
+    _gl->glGenFramebuffers(1, &t.fbo);
+    _gl->glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+    _gl->glGenRenderbuffers(1, &t.depthRb);
+    _gl->glBindRenderbuffer(GL_RENDERBUFFER, t.depthRb);
+    if (samples > 0) {
+        _gl->glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24,
+                size.width(), size.height());
+        _gl->glGenRenderbuffers(1, &t.colorRb);
+        _gl->glBindRenderbuffer(GL_RENDERBUFFER, t.colorRb);
+        _gl->glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format,
+                size.width(), size.height());
+        _gl->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, t.colorRb);
+        _gl->glGenFramebuffers(1, &t.resolveFbo);
+    } else {
+        _gl->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24,
+                size.width(), size.height());
+    }
+    _gl->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, t.depthRb);
+    _gl->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    _targets.append(t);
+    return _targets.size() - 1;
+}
+
+void QVRRenderTargetPool::bind(unsigned int texture, const QSize& size, unsigned int format, int samples)
+{
+    samples = qMin(samples, _maxSamples);
+    if (samples == 1)
+        samples = 0;
+    _current = target(size, format, samples);
+    _currentTexture = texture;
+    Target& t = _targets[_current];
+    t.unusedFrames = 0;
+    _gl->glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+    if (t.samples == 0) {
+        /* Only the attachment changes; QVRWindow allocates the texture */
+        _gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    }
+    _gl->glViewport(0, 0, size.width(), size.height());
+}
+
+void QVRRenderTargetPool::finish()
+{
+    if (_current < 0)
+        return;
+    const Target& t = _targets[_current];
+    if (t.samples > 0) {
+        _gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, t.fbo);
+        _gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, t.resolveFbo);
+        _gl->glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _currentTexture, 0);
+        _gl->glBlitFramebuffer(0, 0, t.size.width(), t.size.height(),
+                0, 0, t.size.width(), t.size.height(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        const GLenum invalidations[] = { GL_COLOR_ATTACHMENT0, GL_DEPTH_ATTACHMENT };
+        _gl->glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, 2, invalidations);
+    } else {
+        const GLenum invalidations[] = { GL_DEPTH_ATTACHMENT };
+        _gl->glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, invalidations);
+    }
+    _gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    _current = -1;
+    _currentTexture = 0;
+}
+
+void QVRRenderTargetPool::endFrame()
+{
+    for (int i = _targets.size() - 1; i >= 0; i--) {
+        if (++_targets[i].unusedFrames > QVRRenderTargetMaxUnusedFrames) {
+            QVR_DEBUG("deleting unused render target %dx%d",
+                    _targets[i].size.width(), _targets[i].size.height());
+            destroy(_targets[i]);
+            _targets.remove(i);
+        }
+    }
+}
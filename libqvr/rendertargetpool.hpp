@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 Computer Graphics Group, University of Siegen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef QVR_RENDERTARGETPOOL_HPP
+#define QVR_RENDERTARGETPOOL_HPP
+
+#include <QSize>
+#include <QVector>
+
+class QOpenGLExtraFunctions;
+
+/* Framebuffer objects for rendering views into QVR textures, shared by all
+ * windows of a process (they all render in the master window context).
+ * Targets are keyed by size, color format and sample count. A target keeps
+ * its depth renderbuffer (and, with multisampling, its color renderbuffer)
+ * for as long as it is used, so binding a texture of a known size never
+ * allocates anything. Targets not used for a while are deleted. */
+class QVRRenderTargetPool
+{
+private:
+    struct Target {
+        QSize size;
+        unsigned int format;
+        int samples;
+        unsigned int fbo;
+        unsigned int depthRb;
+        unsigned int colorRb;    // multisample color, 0 without multisampling
+        unsigned int resolveFbo; // multisample resolve target, 0 without multisampling
+        int unusedFrames;
+    };
+
+    QOpenGLExtraFunctions* _gl;
+    QVector<Target> _targets;
+    int _maxSamples;
+    int _current;
+    unsigned int _currentTexture;
+
+    int target(const QSize& size, unsigned int format, int samples);
+    void destroy(const Target& t);
+
+public:
+    QVRRenderTargetPool();
+    ~QVRRenderTargetPool();
+
+    /* Bind a framebuffer that renders into texture, which must have the
+     * given size and internal format, and set the viewport to cover it. */
+    void bind(unsigned int texture, const QSize& size, unsigned int format, int samples);
+    /* Resolve multisampling into the texture of the last bind() and let the
+     * driver discard the depth buffer. */
+    void finish();
+    /* Called once per frame; deletes targets unused for a few frames. */
+    void endFrame();
+};
+
+#endif
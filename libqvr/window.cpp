@@ -153,6 +153,7 @@ QVRWindow::QVRWindow(QVRWindow* masterWindow, QVRObserver* observer, int windowI
     _textures { 0, 0 },
     _textureWidths { -1, -1 },
     _textureHeights { -1, -1 },
+    _textureFormats { GL_SRGB8_ALPHA8, GL_SRGB8_ALPHA8 },
     _outputQuadVao(0),
     _outputPrg(NULL),
     _renderContext()
@@ -855,6 +856,7 @@ const QVRRenderContext& QVRWindow::computeRenderContext(float n, float f, unsign
                     w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
             _textureWidths[i] = w;
             _textureHeights[i] = h;
+            _textureFormats[i] = wantSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
         }
         _renderContext.setTextureSize(i, QSize(_textureWidths[i], _textureHeights[i]));
     }
@@ -873,6 +875,8 @@ const QVRRenderContext& QVRWindow::computeRenderContext(float n, float f, unsign
         ovr_GetTextureSwapChainBufferGL(QVROculus, QVROculusTextureSwapChainR, -1, &(textures[1]));
     }
 #endif
+    for (int i = 0; i < _renderContext.viewCount(); i++)
+        _renderContext.setTexture(i, textures[i], _textureFormats[i]);
 
     _gl->glBindTexture(GL_TEXTURE_2D, textureBinding2dBak);
 
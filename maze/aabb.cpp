@@ -12,29 +12,45 @@ Aabb::Aabb(QVector3D a
             b.lengthSquared() > a.lengthSquared() ? a : b
           , b.lengthSquared() > a.lengthSquared() ? b : a
         ))
+  , _world(_ab)
+  , _worldRevision(getTransformRevision())
+  , _renderable(renderable)
   , _name(name)
 {
-    if (renderable)
+    if (_renderable)
+        _debugBox = DebugBoxRenderer::instance()->add(this, color);
+}
+
+Aabb::~Aabb()
+{
+    if (_renderable)
+        DebugBoxRenderer::instance()->remove(_debugBox);
+}
+
+BoundingBox Aabb::getBox() const
+{
+    /** World bounds are only recomputed after the transform changed */
+    if (_worldRevision != getTransformRevision())
     {
-        _box = std::make_shared<Box>("AABB", std::vector<QVector3D> {a, b}, color);
-        addChild(_box);
+        QMatrix4x4 m = getModelMatrix();
+
+        _world = BoundingBox(m * _ab.a, m * _ab.b);
+        _worldRevision = getTransformRevision();
     }
+
+    return _world;
 }
 
-BoundingBox Aabb::getBox() const
+unsigned int Aabb::getTransformRevision() const
 {
-   return BoundingBox(
-               getModelMatrix() * _ab.a
-               , getModelMatrix() * _ab.b
-               );
+    return Drawable::getTransformRevision();
 }
 
 std::vector<QVector3D> Aabb::getAB() const
 {
-    return {
-         getModelMatrix() * _ab.a
-        , getModelMatrix() * _ab.b
-        };
+    BoundingBox box = getBox();
+
+    return {box.a, box.b};
 }
 
 BVec Aabb::getOverlap(Aabb &aabb) const
@@ -81,19 +97,16 @@ bool Aabb::hasOverlap(Aabb &aabb) const
     return getOverlap(aabb).all();
 }
 
-void Aabb::glRender(QMatrix4x4 &vMatrix, QMatrix4x4 &pMatrix)
-{
-}
-
+/**
+ * @brief Aabb::setCollided draws the box solid while collided, as outline
+ * otherwise
+ */
 void Aabb::setCollided(bool collided)
 {
-    if (collided && _collided != collided)
-        emit this->collided();
-
     _collided = collided;
 
-    if (_box)
-        _box->setLines(!collided);
+    if (_renderable)
+        DebugBoxRenderer::instance()->setSolid(_debugBox, collided);
 }
 
 bool Aabb::isCollided() const
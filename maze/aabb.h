@@ -6,16 +6,10 @@
 #include <QVector3D>
 #include <QMatrix4x4>
 #include <QObject>
-#include <box.h>
+#include <debugboxrenderer.h>
 #include <bvec.hpp>
-
-struct BoundingBox {
-    QVector3D a;
-    QVector3D b;
-    BoundingBox(QVector3D a, QVector3D b):
-        a(a), b(b)
-    {}
-};
+#include <boundingbox.h>
+#include <collider.h>
 
 struct BoundAxis {
     bool bottom;
@@ -35,7 +29,7 @@ struct Bound {
 
 };
 
-class Aabb : public QObject, public Drawable
+class Aabb : public QObject, public Drawable, public Collider
 {
     Q_OBJECT
 public:
@@ -46,28 +40,28 @@ public:
             , QString name = ""
             , QObject* _parent = nullptr
             );
+    ~Aabb();
 
     BVec virtual getOverlap(Aabb &aabb) const;
     bool virtual hasOverlap(Aabb &aabb) const;
     BVec virtual getContain(Aabb &aabb) const;
     Bound virtual boundsPoint(QVector3D point) const;
-    BoundingBox getBox() const;
+    BoundingBox getBox() const override;
+    unsigned int getTransformRevision() const override;
     std::vector<QVector3D> getAB() const;
     bool isCollided() const;
-    virtual void setCollided(bool collided);
+    void setCollided(bool collided);
     QString getName() const;
-    bool isObstacle() const;
+    bool isObstacle() const override;
 
 private:
-    virtual void glRender(QMatrix4x4 &vMarix, QMatrix4x4 &pMatrix);
-
     BoundingBox _ab;
-    std::shared_ptr<Box> _box;
+    mutable BoundingBox _world;
+    mutable unsigned int _worldRevision;
+    bool _renderable;
+    unsigned int _debugBox = 0;
     bool _collided = false;
     QString _name;
-
-signals:
-    void collided();
 };
 
 #endif // AABB_H
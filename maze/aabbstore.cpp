@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <limits>
+#include "aabbstore.h"
+
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+/** Padding lanes hold inverted boxes that never overlap anything */
+#define EMPTY_MIN std::numeric_limits<float>::max()
+#define EMPTY_MAX -std::numeric_limits<float>::max()
+#define MAX_SLIDES 3
+#define CONTACT_SKIN 1e-4f
+
+namespace {
+
+struct Query {
+    float ax, ay, az;
+    float bx, by, bz;
+    Query(const BoundingBox &box):
+        ax(box.a.x()), ay(box.a.y()), az(box.a.z())
+      , bx(box.b.x()), by(box.b.y()), bz(box.b.z())
+    {}
+};
+
+/**
+ * Tests AabbStore::LANES consecutive boxes against the query and returns one
+ * bit per box.
+ */
+uint32_t overlapBlock(const float *minX, const float *minY, const float *minZ
+        , const float *maxX, const float *maxY, const float *maxZ
+        , const Query &q)
+{
+#if defined(__AVX512F__)
+    __mmask16 m = _mm512_cmp_ps_mask(_mm512_loadu_ps(maxX), _mm512_set1_ps(q.ax), _CMP_GT_OQ);
+    m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(minX), _mm512_set1_ps(q.bx), _CMP_LT_OQ);
+    m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(maxY), _mm512_set1_ps(q.ay), _CMP_GT_OQ);
+    m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(minY), _mm512_set1_ps(q.by), _CMP_LT_OQ);
+    m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(maxZ), _mm512_set1_ps(q.az), _CMP_GT_OQ);
+    m = _mm512_mask_cmp_ps_mask(m, _mm512_loadu_ps(minZ), _mm512_set1_ps(q.bz), _CMP_LT_OQ);
+
+    return static_cast<uint32_t> (m);
+#elif defined(__AVX__)
+    const __m256 ax = _mm256_set1_ps(q.ax), ay = _mm256_set1_ps(q.ay), az = _mm256_set1_ps(q.az);
+    const __m256 bx = _mm256_set1_ps(q.bx), by = _mm256_set1_ps(q.by), bz = _mm256_set1_ps(q.bz);
+    uint32_t bits = 0;
+
+    for (unsigned int i = 0; i < AabbStore::LANES; i += 8)
+    {
+        __m256 m = _mm256_and_ps(
+                    _mm256_cmp_ps(_mm256_loadu_ps(maxX + i), ax, _CMP_GT_OQ)
+                    , _mm256_cmp_ps(_mm256_loadu_ps(minX + i), bx, _CMP_LT_OQ));
+        m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(maxY + i), ay, _CMP_GT_OQ));
+        m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(minY + i), by, _CMP_LT_OQ));
+        m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(maxZ + i), az, _CMP_GT_OQ));
+        m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(minZ + i), bz, _CMP_LT_OQ));
+        bits |= static_cast<uint32_t> (_mm256_movemask_ps(m)) << i;
+    }
+
+    return bits;
+#elif defined(__SSE__) || defined(_M_X64)
+    const __m128 ax = _mm_set1_ps(q.ax), ay = _mm_set1_ps(q.ay), az = _mm_set1_ps(q.az);
+    const __m128 bx = _mm_set1_ps(q.bx), by = _mm_set1_ps(q.by), bz = _mm_set1_ps(q.bz);
+    uint32_t bits = 0;
+
+    for (unsigned int i = 0; i < AabbStore::LANES; i += 4)
+    {
+        __m128 m = _mm_and_ps(
+                    _mm_cmpgt_ps(_mm_loadu_ps(maxX + i), ax)
+                    , _mm_cmplt_ps(_mm_loadu_ps(minX + i), bx));
+        m = _mm_and_ps(m, _mm_cmpgt_ps(_mm_loadu_ps(maxY + i), ay));
+        m = _mm_and_ps(m, _mm_cmplt_ps(_mm_loadu_ps(minY + i), by));
+        m = _mm_and_ps(m, _mm_cmpgt_ps(_mm_loadu_ps(maxZ + i), az));
+        m = _mm_and_ps(m, _mm_cmplt_ps(_mm_loadu_ps(minZ + i), bz));
+        bits |= static_cast<uint32_t> (_mm_movemask_ps(m)) << i;
+    }
+
+    return bits;
+#else
+    uint32_t bits = 0;
+
+    for (unsigned int i = 0; i < AabbStore::LANES; i++)
+    {
+        bool hit = maxX[i] > q.ax && minX[i] < q.bx
+                && maxY[i] > q.ay && minY[i] < q.by
+                && maxZ[i] > q.az && minZ[i] < q.bz;
+
+        bits |= static_cast<uint32_t> (hit) << i;
+    }
+
+    return bits;
+#endif
+}
+
+void storeBits(std::vector<uint32_t> &mask, unsigned int offset, uint32_t bits)
+{
+    mask[offset / 32] |= bits << (offset % 32);
+}
+
+}
+
+const unsigned int AabbStore::LANES;
+
+AabbStore::AabbStore()
+{
+    pad();
+}
+
+void AabbStore::pad()
+{
+    /** Keep at least one full block of padding behind the last box so that
+     *  blocks starting anywhere inside [0, size) can be loaded */
+    size_t capacity = (_size + LANES - 1) / LANES * LANES + LANES;
+
+    if (_minX.size() >= capacity)
+        return;
+
+    _minX.resize(capacity, EMPTY_MIN);
+    _minY.resize(capacity, EMPTY_MIN);
+    _minZ.resize(capacity, EMPTY_MIN);
+    _maxX.resize(capacity, EMPTY_MAX);
+    _maxY.resize(capacity, EMPTY_MAX);
+    _maxZ.resize(capacity, EMPTY_MAX);
+}
+
+unsigned int AabbStore::add(const BoundingBox &box)
+{
+    unsigned int id = _size++;
+
+    pad();
+    set(id, box);
+
+    return id;
+}
+
+void AabbStore::set(unsigned int id, const BoundingBox &box)
+{
+    _minX[id] = std::min(box.a.x(), box.b.x());
+    _minY[id] = std::min(box.a.y(), box.b.y());
+    _minZ[id] = std::min(box.a.z(), box.b.z());
+    _maxX[id] = std::max(box.a.x(), box.b.x());
+    _maxY[id] = std::max(box.a.y(), box.b.y());
+    _maxZ[id] = std::max(box.a.z(), box.b.z());
+}
+
+void AabbStore::clear()
+{
+    _size = 0;
+    _minX.clear();
+    _minY.clear();
+    _minZ.clear();
+    _maxX.clear();
+    _maxY.clear();
+    _maxZ.clear();
+    pad();
+}
+
+unsigned int AabbStore::size() const
+{
+    return _size;
+}
+
+BoundingBox AabbStore::get(unsigned int id) const
+{
+    return BoundingBox(
+                QVector3D(_minX[id], _minY[id], _minZ[id])
+                , QVector3D(_maxX[id], _maxY[id], _maxZ[id])
+                );
+}
+
+BVec AabbStore::axisOverlap(unsigned int id, const BoundingBox &box) const
+{
+    return BVec(
+                _maxX[id] > box.a.x() && box.b.x() > _minX[id]
+                , _maxY[id] > box.a.y() && box.b.y() > _minY[id]
+                , _maxZ[id] > box.a.z() && box.b.z() > _minZ[id]
+                );
+}
+
+void AabbStore::overlap(const BoundingBox &box, unsigned int first, unsigned int count
+        , std::vector<uint32_t> &mask) const
+{
+    Query q(box);
+
+    mask.assign((count + 31) / 32, 0);
+
+    for (unsigned int i = 0; i < count; i += LANES)
+    {
+        unsigned int k = first + i;
+        uint32_t bits = overlapBlock(&_minX[k], &_minY[k], &_minZ[k]
+                , &_maxX[k], &_maxY[k], &_maxZ[k], q);
+
+        if (count - i < LANES)
+            bits &= (1u << (count - i)) - 1;
+
+        storeBits(mask, i, bits);
+    }
+}
+
+void AabbStore::overlap(const BoundingBox &box, const unsigned int *ids, unsigned int count
+        , std::vector<uint32_t> &mask) const
+{
+    Query q(box);
+    float minX[LANES], minY[LANES], minZ[LANES];
+    float maxX[LANES], maxY[LANES], maxZ[LANES];
+
+    mask.assign((count + 31) / 32, 0);
+
+    for (unsigned int i = 0; i < count; i += LANES)
+    {
+        unsigned int n = std::min(count - i, LANES);
+
+        /** Gather the scattered candidates into one block */
+        for (unsigned int j = 0; j < LANES; j++)
+        {
+            unsigned int id = j < n ? ids[i + j] : _size;
+
+            minX[j] = _minX[id];
+            minY[j] = _minY[id];
+            minZ[j] = _minZ[id];
+            maxX[j] = _maxX[id];
+            maxY[j] = _maxY[id];
+            maxZ[j] = _maxZ[id];
+        }
+
+        storeBits(mask, i, overlapBlock(minX, minY, minZ, maxX, maxY, maxZ, q));
+    }
+}
+
+/**
+ * @brief AabbStore::sweep finds the first stored box hit by box moving along
+ * movement
+ *
+ * Uses the slab test on the Minkowski difference per axis. Boxes that already
+ * overlap at the start are ignored, so a box can always move out of a
+ * collider it got stuck in.
+ */
+Contact AabbStore::sweep(const BoundingBox &box, QVector3D movement
+        , const unsigned int *ids, unsigned int count) const
+{
+    Contact contact;
+    const float inf = std::numeric_limits<float>::infinity();
+
+    for (unsigned int k = 0; k < count; k++)
+    {
+        unsigned int id = ids[k];
+        const float min[3] = {_minX[id], _minY[id], _minZ[id]};
+        const float max[3] = {_maxX[id], _maxY[id], _maxZ[id]};
+        float enter = -inf;
+        float exit = inf;
+        int axis = -1;
+        bool miss = false;
+
+        for (int i = 0; i < 3 && !miss; i++)
+        {
+            float d = movement[i];
+            float a = box.a[i];
+            float b = box.b[i];
+            float t0, t1;
+
+            if (d == 0.f)
+            {
+                miss = b <= min[i] || a >= max[i];
+                continue;
+            }
+
+            if (d > 0.f)
+            {
+                t0 = (min[i] - b) / d;
+                t1 = (max[i] - a) / d;
+            }
+            else
+            {
+                t0 = (max[i] - a) / d;
+                t1 = (min[i] - b) / d;
+            }
+
+            if (t0 > enter)
+            {
+                enter = t0;
+                axis = i;
+            }
+            exit = std::min(exit, t1);
+        }
+
+        if (miss || axis < 0 || enter < 0.f || enter >= exit || enter >= contact.time)
+            continue;
+
+        contact.hit = true;
+        contact.time = enter;
+        contact.id = id;
+        contact.normal = QVector3D();
+        contact.normal[axis] = movement[axis] > 0.f ? -1.f : 1.f;
+    }
+
+    return contact;
+}
+
+QVector3D slideMove(BoundingBox box, QVector3D movement
+        , std::function<Contact(const BoundingBox &, QVector3D)> sweep)
+{
+    QVector3D moved;
+
+    for (int i = 0; i < MAX_SLIDES && !movement.isNull(); i++)
+    {
+        Contact contact = sweep(box, movement);
+
+        if (!contact.hit)
+        {
+            moved += movement;
+            break;
+        }
+
+        QVector3D step = movement * contact.time + contact.normal * CONTACT_SKIN;
+
+        moved += step;
+        box = BoundingBox(box.a + step, box.b + step);
+        movement *= 1.f - contact.time;
+        movement -= contact.normal * QVector3D::dotProduct(movement, contact.normal);
+    }
+
+    return moved;
+}
@@ -0,0 +1,78 @@
+#ifndef AABBSTORE_H
+#define AABBSTORE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <boundingbox.h>
+#include <bvec.hpp>
+
+/**
+ * @brief Result of a swept box query
+ *
+ * time is the fraction of the movement after which the boxes touch, normal
+ * the face normal of the stored box that was hit.
+ */
+struct Contact {
+    bool hit;
+    float time;
+    QVector3D normal;
+    unsigned int id;
+    Contact():
+        hit(false), time(1.f), normal(), id(0)
+    {}
+};
+
+/**
+ * @brief The AabbStore class keeps world-space collider bounds as packed
+ * structure-of-arrays floats
+ *
+ * Overlap queries test one box against blocks of LANES stored boxes, each
+ * comparison of a block taking one instruction with AVX-512, two of 8 lanes
+ * with AVX or four of 4 lanes with SSE; the kernels are chosen at compile
+ * time, see the MAZE_AVX and MAZE_AVX512 build options. Hits are reported as
+ * a bitmask: bit i % 32 of word i / 32 is set when the i-th tested box
+ * overlaps.
+ */
+class AabbStore
+{
+public:
+    static const unsigned int LANES = 16;
+
+    AabbStore();
+
+    unsigned int add(const BoundingBox &box);
+    void set(unsigned int id, const BoundingBox &box);
+    void clear();
+    unsigned int size() const;
+    BoundingBox get(unsigned int id) const;
+    BVec axisOverlap(unsigned int id, const BoundingBox &box) const;
+
+    void overlap(const BoundingBox &box, unsigned int first, unsigned int count
+            , std::vector<uint32_t> &mask) const;
+    void overlap(const BoundingBox &box, const unsigned int *ids, unsigned int count
+            , std::vector<uint32_t> &mask) const;
+    Contact sweep(const BoundingBox &box, QVector3D movement
+            , const unsigned int *ids, unsigned int count) const;
+
+private:
+    void pad();
+
+    unsigned int _size = 0;
+    std::vector<float> _minX;
+    std::vector<float> _minY;
+    std::vector<float> _minZ;
+    std::vector<float> _maxX;
+    std::vector<float> _maxY;
+    std::vector<float> _maxZ;
+};
+
+/**
+ * @brief slideMove moves box along movement up to the first contact reported
+ * by sweep and slides along the contact plane with the rest, for up to
+ * MAX_SLIDES contacts; returns the actual displacement
+ */
+QVector3D slideMove(BoundingBox box, QVector3D movement
+        , std::function<Contact(const BoundingBox &, QVector3D)> sweep);
+
+#endif // AABBSTORE_H
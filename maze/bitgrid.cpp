@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <bitops.hpp>
+#include "bitgrid.h"
+
+BitGrid::BitGrid(int width, int height)
+{
+    reset(width, height);
+}
+
+void BitGrid::reset(int width, int height)
+{
+    _width = std::max(width, 0);
+    _height = std::max(height, 0);
+    _stride = static_cast<size_t> (_width + 2 + 63) / 64 + 1;
+    _words.assign(_stride * static_cast<size_t> (_height + 2), 0);
+}
+
+int BitGrid::width() const
+{
+    return _width;
+}
+
+int BitGrid::height() const
+{
+    return _height;
+}
+
+bool BitGrid::at(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return false;
+
+    return get(x, y);
+}
+
+void BitGrid::set(int x, int y, bool value)
+{
+    size_t c = static_cast<size_t> (x + 1);
+    uint64_t &word = _words[rowOffset(y) + c / 64];
+    uint64_t bit = uint64_t(1) << (c % 64);
+
+    word = (word & ~bit) | (value ? bit : 0);
+}
+
+/**
+ * @brief BitGrid::setSpan sets cells x0 up to, not including, x1 of row y
+ * a word at a time
+ */
+void BitGrid::setSpan(int y, int x0, int x1, bool value)
+{
+    uint64_t *words = &_words[rowOffset(y)];
+
+    for (size_t c = static_cast<size_t> (x0 + 1), end = static_cast<size_t> (x1 + 1); c < end; )
+    {
+        size_t shift = c % 64;
+        size_t n = std::min(64 - shift, end - c);
+        uint64_t mask = lowBits(static_cast<int> (n)) << shift;
+
+        words[c / 64] = value ? words[c / 64] | mask : words[c / 64] & ~mask;
+        c += n;
+    }
+}
+
+/**
+ * @brief BitGrid::row returns the 64 cells x to x + 63 of row y, cell x in
+ * bit 0; cells past the padding border read as clear
+ */
+uint64_t BitGrid::row(int x, int y) const
+{
+    size_t c = static_cast<size_t> (x + 1);
+    const uint64_t *words = &_words[rowOffset(y) + c / 64];
+    unsigned int shift = c % 64;
+
+    /** Split the high shift in two so that shift == 0 stays defined */
+    return (words[0] >> shift) | ((words[1] << 1) << (63 - shift));
+}
+
+/**
+ * @brief BitGrid::runLength counts the consecutive set cells starting at
+ * (x, y), up to max
+ */
+int BitGrid::runLength(int x, int y, int max) const
+{
+    int n = 0;
+
+    while (n < max)
+    {
+        uint64_t clear = ~row(x + n, y);
+
+        if (clear)
+            return std::min(max, n + ctz64(clear));
+
+        n += 64;
+    }
+
+    return max;
+}
+
+bool BitGrid::allSet(int x, int y, int count) const
+{
+    for (int i = 0; i < count; i += 64)
+    {
+        uint64_t mask = lowBits(count - i);
+
+        if ((row(x + i, y) & mask) != mask)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief BitGrid::neighbours returns the set direct neighbours of (x, y) as
+ * Neighbour bits; (x, y) must lie inside the grid
+ */
+unsigned int BitGrid::neighbours(int x, int y) const
+{
+    return static_cast<unsigned int> (get(x - 1, y))
+            | static_cast<unsigned int> (get(x + 1, y)) << 1
+            | static_cast<unsigned int> (get(x, y - 1)) << 2
+            | static_cast<unsigned int> (get(x, y + 1)) << 3;
+}
+
+/**
+ * @brief BitGrid::count returns the number of set cells inside the grid
+ */
+size_t BitGrid::count() const
+{
+    size_t n = 0;
+
+    for (int y = 0; y < _height; y++)
+        for (int x = 0; x < _width; x += 64)
+            n += static_cast<size_t> (popcount64(row(x, y) & lowBits(_width - x)));
+
+    return n;
+}
+
+/**
+ * @brief BitGrid::nth finds the n-th set cell (counting from 0) in row-major
+ * order, skipping whole words by their popcount
+ */
+bool BitGrid::nth(size_t n, int &x, int &y) const
+{
+    for (y = 0; y < _height; y++)
+        for (x = 0; x < _width; x += 64)
+        {
+            uint64_t bits = row(x, y) & lowBits(_width - x);
+            size_t c = static_cast<size_t> (popcount64(bits));
+
+            if (n >= c)
+            {
+                n -= c;
+                continue;
+            }
+
+            for (; n > 0; n--)
+                bits &= bits - 1;
+
+            x += ctz64(bits);
+
+            return true;
+        }
+
+    return false;
+}
+
+/**
+ * @brief BitGrid::inverted returns a grid with the cells inside flipped and
+ * a clear padding border
+ */
+BitGrid BitGrid::inverted() const
+{
+    BitGrid grid(_width, _height);
+
+    for (int y = 0; y < _height; y++)
+    {
+        grid.setSpan(y, 0, _width, true);
+
+        for (size_t i = 0; i < _stride; i++)
+            grid._words[rowOffset(y) + i] &= ~_words[rowOffset(y) + i];
+    }
+
+    return grid;
+}
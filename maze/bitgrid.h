@@ -0,0 +1,66 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The BitGrid class stores a width x height grid of flags, one bit
+ * per cell, in row-aligned 64 bit words
+ *
+ * The grid is surrounded by a one cell padding border, so cells -1 and
+ * width/height can be read without bounds checks; the border is clear unless
+ * set explicitly. Every row additionally ends in a spare zero word, which
+ * lets row() read 64 cells starting anywhere in the row without branching.
+ */
+class BitGrid
+{
+public:
+    /** Bits of neighbours() */
+    enum Neighbour {
+        WEST = 1,   // x - 1
+        EAST = 2,   // x + 1
+        NORTH = 4,  // y - 1
+        SOUTH = 8   // y + 1
+    };
+
+    BitGrid(int width = 0, int height = 0);
+
+    void reset(int width, int height);
+    int width() const;
+    int height() const;
+
+    /** Cell (x, y) for -1 <= x <= width, -1 <= y <= height */
+    bool get(int x, int y) const
+    {
+        size_t c = static_cast<size_t> (x + 1);
+
+        return (_words[rowOffset(y) + c / 64] >> (c % 64)) & 1;
+    }
+
+    /** Cell (x, y) for any coordinates, false outside of the grid */
+    bool at(int x, int y) const;
+    void set(int x, int y, bool value);
+    void setSpan(int y, int x0, int x1, bool value);
+    uint64_t row(int x, int y) const;
+    int runLength(int x, int y, int max) const;
+    bool allSet(int x, int y, int count) const;
+    unsigned int neighbours(int x, int y) const;
+    size_t count() const;
+    bool nth(size_t n, int &x, int &y) const;
+    BitGrid inverted() const;
+
+private:
+    size_t rowOffset(int y) const
+    {
+        return static_cast<size_t> (y + 1) * _stride;
+    }
+
+    int _width = 0;
+    int _height = 0;
+    size_t _stride = 0;
+    std::vector<uint64_t> _words;
+};
+
+#endif // BITGRID_H
@@ -0,0 +1,50 @@
+#ifndef BITOPS_HPP
+#define BITOPS_HPP
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/** Index of the lowest set bit; bits must not be zero */
+inline int ctz(uint32_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, bits);
+    return static_cast<int> (idx);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+/** Index of the lowest set bit of a 64 bit word; bits must not be zero */
+inline int ctz64(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, bits);
+    return static_cast<int> (idx);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+/** Number of set bits */
+inline int popcount64(uint64_t bits)
+{
+#ifdef _MSC_VER
+    return static_cast<int> (__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+/** The lowest n bits set, n may be anything from 0 up */
+inline uint64_t lowBits(int n)
+{
+    return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+}
+
+#endif // BITOPS_HPP
@@ -0,0 +1,32 @@
+#ifndef BOUNDINGBOX_H
+#define BOUNDINGBOX_H
+
+#include <algorithm>
+#include <QVector3D>
+
+struct BoundingBox {
+    QVector3D a;
+    QVector3D b;
+    BoundingBox(QVector3D a, QVector3D b):
+        a(a), b(b)
+    {}
+};
+
+/**
+ * @brief sweptBox returns the bounds of box over its whole way along movement
+ */
+inline BoundingBox sweptBox(const BoundingBox &box, QVector3D movement)
+{
+    BoundingBox moved = BoundingBox(box.a + movement, box.b + movement);
+
+    return BoundingBox(
+                QVector3D(std::min(box.a.x(), moved.a.x())
+                          , std::min(box.a.y(), moved.a.y())
+                          , std::min(box.a.z(), moved.a.z()))
+                , QVector3D(std::max(box.b.x(), moved.b.x())
+                            , std::max(box.b.y(), moved.b.y())
+                            , std::max(box.b.z(), moved.b.z()))
+                );
+}
+
+#endif // BOUNDINGBOX_H
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <limits>
+#include <bitops.hpp>
+#include "bvh.h"
+
+Bvh::Bvh():
+    _base(0), _size(0)
+{
+}
+
+void Bvh::build(std::vector<BoundingBox> &boxes, unsigned int base)
+{
+    _nodes.clear();
+    _base = base;
+    _size = static_cast<unsigned int> (boxes.size());
+
+    if (!boxes.empty())
+        build(boxes, 0, _size);
+}
+
+unsigned int Bvh::build(std::vector<BoundingBox> &boxes, unsigned int first, unsigned int count)
+{
+    unsigned int index = static_cast<unsigned int> (_nodes.size());
+    Node node;
+    float cmin[3], cmax[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        node.min[i] = cmin[i] = std::numeric_limits<float>::max();
+        node.max[i] = cmax[i] = -std::numeric_limits<float>::max();
+    }
+
+    for (unsigned int k = first; k < first + count; k++)
+        for (int i = 0; i < 3; i++)
+        {
+            const BoundingBox &box = boxes[k];
+            float c = (box.a[i] + box.b[i]) * 0.5f;
+
+            node.min[i] = std::min(node.min[i], std::min(box.a[i], box.b[i]));
+            node.max[i] = std::max(node.max[i], std::max(box.a[i], box.b[i]));
+            cmin[i] = std::min(cmin[i], c);
+            cmax[i] = std::max(cmax[i], c);
+        }
+
+    node.first = first;
+    node.count = count;
+    _nodes.push_back(node);
+
+    if (count <= AabbStore::LANES)
+        return index;
+
+    /** Median split along the longest extent of the box centers */
+    int axis = 0;
+
+    for (int i = 1; i < 3; i++)
+        if (cmax[i] - cmin[i] > cmax[axis] - cmin[axis])
+            axis = i;
+
+    unsigned int mid = first + count / 2;
+
+    std::nth_element(boxes.begin() + first, boxes.begin() + mid, boxes.begin() + first + count
+                     , [axis](const BoundingBox &l, const BoundingBox &r)
+    {
+        return l.a[axis] + l.b[axis] < r.a[axis] + r.b[axis];
+    });
+
+    build(boxes, first, mid - first);
+    unsigned int right = build(boxes, mid, first + count - mid);
+
+    _nodes[index].first = right;
+    _nodes[index].count = 0;
+
+    return index;
+}
+
+void Bvh::query(const BoundingBox &box, const AabbStore &store, std::vector<unsigned int> &result) const
+{
+    if (_nodes.empty())
+        return;
+
+    _stack.assign(1, 0);
+
+    while (!_stack.empty())
+    {
+        const Node &node = _nodes[_stack.back()];
+        unsigned int index = _stack.back();
+
+        _stack.pop_back();
+
+        if (!(node.max[0] > box.a.x() && box.b.x() > node.min[0]
+              && node.max[1] > box.a.y() && box.b.y() > node.min[1]
+              && node.max[2] > box.a.z() && box.b.z() > node.min[2]))
+            continue;
+
+        if (node.count == 0)
+        {
+            _stack.push_back(node.first);
+            _stack.push_back(index + 1);
+            continue;
+        }
+
+        store.overlap(box, _base + node.first, node.count, _mask);
+
+        for (uint32_t bits = _mask[0]; bits != 0; bits &= bits - 1)
+            result.push_back(_base + node.first + static_cast<unsigned int> (ctz(bits)));
+    }
+}
+
+bool Bvh::rayBox(QVector3D origin, QVector3D invDirection
+        , const float min[3], const float max[3], float maxTime, float &time)
+{
+    float enter = 0.f;
+    float exit = maxTime;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float t0 = (min[i] - origin[i]) * invDirection[i];
+        float t1 = (max[i] - origin[i]) * invDirection[i];
+
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        /** NaN from 0 * inf (ray inside a slab boundary) keeps the old value */
+        enter = t0 > enter ? t0 : enter;
+        exit = t1 < exit ? t1 : exit;
+    }
+
+    time = enter;
+
+    return enter <= exit;
+}
+
+RayHit Bvh::raycast(QVector3D origin, QVector3D direction, float maxTime, const AabbStore &store) const
+{
+    RayHit hit;
+
+    if (_nodes.empty())
+        return hit;
+
+    QVector3D inv = QVector3D(1.f / direction.x(), 1.f / direction.y(), 1.f / direction.z());
+    float best = maxTime;
+
+    _stack.assign(1, 0);
+
+    while (!_stack.empty())
+    {
+        unsigned int index = _stack.back();
+        const Node &node = _nodes[index];
+        float t;
+
+        _stack.pop_back();
+
+        if (!rayBox(origin, inv, node.min, node.max, best, t))
+            continue;
+
+        if (node.count == 0)
+        {
+            _stack.push_back(node.first);
+            _stack.push_back(index + 1);
+            continue;
+        }
+
+        for (unsigned int k = 0; k < node.count; k++)
+        {
+            unsigned int id = _base + node.first + k;
+            BoundingBox box = store.get(id);
+            const float min[3] = {box.a.x(), box.a.y(), box.a.z()};
+            const float max[3] = {box.b.x(), box.b.y(), box.b.z()};
+
+            if (rayBox(origin, inv, min, max, best, t))
+            {
+                hit.hit = true;
+                hit.time = t;
+                hit.id = id;
+                best = t;
+            }
+        }
+    }
+
+    return hit;
+}
+
+unsigned int Bvh::size() const
+{
+    return _size;
+}
@@ -0,0 +1,59 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <vector>
+#include <boundingbox.h>
+#include <aabbstore.h>
+
+/**
+ * @brief Result of a ray query; time is measured in units of the ray direction
+ */
+struct RayHit {
+    bool hit;
+    float time;
+    unsigned int id;
+    RayHit():
+        hit(false), time(0.f), id(0)
+    {}
+};
+
+/**
+ * @brief The Bvh class is a static bounding volume hierarchy over colliders
+ * that never move
+ *
+ * build() reorders the boxes so that every leaf covers a contiguous run of at
+ * most AabbStore::LANES boxes. The boxes are expected to be added to the
+ * store in that order starting at id base, so leaves are tested with a single
+ * SIMD block.
+ */
+class Bvh
+{
+public:
+    Bvh();
+
+    void build(std::vector<BoundingBox> &boxes, unsigned int base);
+    void query(const BoundingBox &box, const AabbStore &store, std::vector<unsigned int> &result) const;
+    RayHit raycast(QVector3D origin, QVector3D direction, float maxTime, const AabbStore &store) const;
+    unsigned int size() const;
+
+    static bool rayBox(QVector3D origin, QVector3D invDirection
+            , const float min[3], const float max[3], float maxTime, float &time);
+
+private:
+    struct Node {
+        float min[3];
+        float max[3];
+        unsigned int first;     // first box of a leaf, right child of an inner node
+        unsigned int count;     // number of boxes of a leaf, 0 for inner nodes
+    };
+
+    unsigned int build(std::vector<BoundingBox> &boxes, unsigned int first, unsigned int count);
+
+    std::vector<Node> _nodes;
+    unsigned int _base;
+    unsigned int _size;
+    mutable std::vector<unsigned int> _stack;
+    mutable std::vector<uint32_t> _mask;
+};
+
+#endif // BVH_H
@@ -0,0 +1,22 @@
+#ifndef COLLIDER_H
+#define COLLIDER_H
+
+#include <boundingbox.h>
+
+/**
+ * @brief The Collider class is what MazeModel needs to know about a box in
+ * the maze, independent of how (or whether) it is drawn
+ */
+class Collider
+{
+public:
+    virtual ~Collider() {}
+
+    virtual BoundingBox getBox() const = 0;
+    /** Changes whenever getBox() may have changed */
+    virtual unsigned int getTransformRevision() const = 0;
+    /** Obstacles block movement, other colliders are only hit by rays */
+    virtual bool isObstacle() const = 0;
+};
+
+#endif // COLLIDER_H
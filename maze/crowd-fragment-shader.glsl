@@ -0,0 +1,14 @@
+smooth in mediump vec3 vnormal;
+smooth in mediump vec3 vview;
+flat in mediump float vphase;
+
+layout(location = 0) out vec4 fcolor;
+
+void main(void)
+{
+    // walkers heading for a button are orange, those heading for a goal green
+    lowp vec3 color = mix(vec3(1.0, 0.5, 0.0), vec3(0.0, 0.8, 0.2), vphase);
+    // light is always at camera pos
+    mediump float d = max(dot(normalize(vnormal), normalize(vview)), 0.0);
+    fcolor = vec4(color * (0.3 + 0.7 * d), 1.0);
+}
@@ -0,0 +1,33 @@
+$VIEWS
+
+layout(std140) uniform Camera
+{
+    mat4 view_matrices[MAX_VIEWS];
+    mat4 projection_matrices[MAX_VIEWS];
+};
+
+layout(std140) uniform Object
+{
+    mat4 model_matrix;
+    vec4 object_color;
+};
+
+layout(location = 0) in vec4 pos;
+layout(location = 1) in vec3 normal;
+layout(location = 3) in vec4 instance; // xyz: position, w: phase
+
+smooth out vec3 vnormal;
+smooth out vec3 vview;
+flat out float vphase;
+
+void main(void)
+{
+    mat4 view_matrix = view_matrices[VIEW_ID];
+    mat4 projection_matrix = projection_matrices[VIEW_ID];
+    mat4 model_view_matrix = view_matrix * model_matrix;
+    vec4 p = model_view_matrix * vec4(pos.xyz + instance.xyz, 1.0);
+    vnormal = mat3(model_view_matrix) * normal;
+    vview = -p.xyz;
+    vphase = instance.w;
+    gl_Position = projection_matrix * p;
+}
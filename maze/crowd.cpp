@@ -0,0 +1,421 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <geometries.hpp>
+#include "crowd.h"
+
+#define AGENT_RADIUS 0.15f
+#define AGENT_SPEED 0.0015f
+#define AGENT_SKIN 1e-3f
+#define MIN_AGENTS_PER_THREAD 512
+
+namespace {
+
+int block(float v)
+{
+    return static_cast<int> (std::floor(v + 0.5f));
+}
+
+}
+
+Crowd::Crowd(const BitGrid &open, FlowField toButtons, FlowField toGoals) :
+    Drawable("Crowd"), _open(open), _fields{toButtons, toGoals}
+{
+    std::vector<float> positions, normals, texcoords;
+    std::vector<unsigned short> indices;
+
+    geom_cube(positions, normals, texcoords, indices);
+
+    std::vector<QVector3D> vertices, vertexNormals;
+    std::vector<QVector2D> vertexTexcoords;
+
+    for (size_t i = 0; i < positions.size() / 3; i++)
+    {
+        vertices.push_back(QVector3D(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]) * AGENT_RADIUS);
+        vertexNormals.push_back(QVector3D(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]));
+        vertexTexcoords.push_back(QVector2D(texcoords[2 * i], texcoords[2 * i + 1]));
+    }
+
+    Drawable::initBuffers(&vertices, &vertexNormals, &vertexTexcoords, &indices);
+    _indexCount = static_cast<GLsizei> (indices.size());
+    Drawable::loadShader(
+                ":crowd-vertex-shader.glsl"
+                , ":crowd-fragment-shader.glsl"
+                );
+
+    /** Per instance position and phase, attribute 3 of the box VAO */
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    f->glBindVertexArray(getVao());
+    f->glGenBuffers(1, &_instanceBuf);
+    f->glBindBuffer(GL_ARRAY_BUFFER, _instanceBuf);
+    f->glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+    f->glVertexAttribDivisor(3, 1);
+    f->glEnableVertexAttribArray(3);
+    f->glBindVertexArray(0);
+}
+
+Crowd::~Crowd()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _start.notify_all();
+
+    for (std::thread &w : _workers)
+        w.join();
+}
+
+void Crowd::spawn(const std::vector<QVector3D> &positions)
+{
+    for (QVector3D p : positions)
+    {
+        _posX.push_back(p.x());
+        _posZ.push_back(p.z());
+        _spawnX.push_back(p.x());
+        _spawnZ.push_back(p.z());
+        _phase.push_back(0);
+        _arrived.push_back(0);
+    }
+
+    _nextX.resize(_posX.size());
+    _nextZ.resize(_posZ.size());
+    _revision++;
+}
+
+void Crowd::setTriggers(TriggerSystem &triggers)
+{
+    _triggers = &triggers;
+    _actor = triggers.addActor();
+}
+
+unsigned int Crowd::size() const
+{
+    return static_cast<unsigned int> (_posX.size());
+}
+
+/**
+ * @brief Crowd::bin sorts the agents by the block they stand on (counting
+ * sort), so neighbours are found by looking at the 3x3 blocks around
+ */
+void Crowd::bin()
+{
+    size_t cells = static_cast<size_t> (_open.width()) * static_cast<size_t> (_open.height());
+    auto cell = [this](unsigned int i)
+    {
+        int x = std::min(std::max(block(_posX[i]), 0), _open.width() - 1);
+        int z = std::min(std::max(block(_posZ[i]), 0), _open.height() - 1);
+
+        return static_cast<size_t> (z) * static_cast<size_t> (_open.width()) + static_cast<size_t> (x);
+    };
+
+    _cellStart.assign(cells + 1, 0);
+    _sorted.resize(_posX.size());
+
+    for (unsigned int i = 0; i < size(); i++)
+        _cellStart[cell(i) + 1]++;
+    for (size_t c = 1; c <= cells; c++)
+        _cellStart[c] += _cellStart[c - 1];
+
+    _cellFill.assign(_cellStart.begin(), _cellStart.end() - 1);
+
+    for (unsigned int i = 0; i < size(); i++)
+        _sorted[_cellFill[cell(i)]++] = i;
+}
+
+/**
+ * @brief Crowd::blocked tells whether an agent at (x, z) overlaps a closed
+ * block
+ */
+bool Crowd::blocked(float x, float z) const
+{
+    int x0 = block(x - AGENT_RADIUS), x1 = block(x + AGENT_RADIUS);
+    int z0 = block(z - AGENT_RADIUS), z1 = block(z + AGENT_RADIUS);
+
+    return !_open.at(x0, z0) || !_open.at(x1, z0) || !_open.at(x0, z1) || !_open.at(x1, z1);
+}
+
+void Crowd::stepRange(unsigned int first, unsigned int last, float dt)
+{
+    const int width = _open.width();
+    const int height = _open.height();
+    const float contact = 2.f * AGENT_RADIUS;
+
+    for (unsigned int i = first; i < last; i++)
+    {
+        const FlowField &field = _fields[_phase[i]];
+        float px = _posX[i];
+        float pz = _posZ[i];
+        QVector3D flow = field.flow(QVector3D(px, 0.f, pz));
+        float dx = flow.x() * AGENT_SPEED * dt;
+        float dz = flow.z() * AGENT_SPEED * dt;
+        int bx = block(px);
+        int bz = block(pz);
+
+        /** flow() gives no heading inside the target block, head for its
+         *  centre, where the trigger is */
+        if (field.distance(bx, bz) == 0)
+        {
+            float cx = bx - px;
+            float cz = bz - pz;
+            float len = std::sqrt(cx * cx + cz * cz);
+            float speed = AGENT_SPEED * dt;
+
+            dx = len > speed ? cx / len * speed : cx;
+            dz = len > speed ? cz / len * speed : cz;
+        }
+
+        /** Push apart from overlapping neighbours, half the overlap each */
+        for (int z = std::max(bz - 1, 0); z <= std::min(bz + 1, height - 1); z++)
+            for (int x = std::max(bx - 1, 0); x <= std::min(bx + 1, width - 1); x++)
+            {
+                size_t c = static_cast<size_t> (z) * static_cast<size_t> (width) + static_cast<size_t> (x);
+
+                for (unsigned int k = _cellStart[c]; k < _cellStart[c + 1]; k++)
+                {
+                    unsigned int j = _sorted[k];
+                    float ox = px - _posX[j];
+                    float oz = pz - _posZ[j];
+                    float d2 = ox * ox + oz * oz;
+
+                    if (j == i || d2 >= contact * contact)
+                        continue;
+
+                    float d = std::sqrt(d2);
+                    float norm = d;
+
+                    /** Coincident agents separate along a fixed per-pair axis */
+                    if (d < 1e-6f)
+                    {
+                        ox = i < j ? 1.f : -1.f;
+                        oz = 0.f;
+                        norm = 1.f;
+                    }
+
+                    float push = 0.5f * (contact - d) / norm;
+
+                    dx += ox * push;
+                    dz += oz * push;
+                }
+            }
+
+        /** Walls, one axis at a time so agents slide along them */
+        float nx = px + dx;
+
+        if (blocked(nx, pz))
+            nx = dx > 0.f ? block(nx + AGENT_RADIUS) - 0.5f - AGENT_RADIUS - AGENT_SKIN
+                          : block(nx - AGENT_RADIUS) + 0.5f + AGENT_RADIUS + AGENT_SKIN;
+        if (blocked(nx, pz))
+            nx = px;
+
+        float nz = pz + dz;
+
+        if (blocked(nx, nz))
+            nz = dz > 0.f ? block(nz + AGENT_RADIUS) - 0.5f - AGENT_RADIUS - AGENT_SKIN
+                          : block(nz - AGENT_RADIUS) + 0.5f + AGENT_RADIUS + AGENT_SKIN;
+        if (blocked(nx, nz))
+            nz = pz;
+
+        _nextX[i] = nx;
+        _nextZ[i] = nz;
+        _arrived[i] = arrived(field, nx, nz);
+    }
+}
+
+/**
+ * @brief Crowd::arrived tells whether a walker at (x, z) has reached the
+ * target of field: it must be in a target block and no further than
+ * AGENT_RADIUS from its centre, so its box overlaps a trigger centred there
+ */
+bool Crowd::arrived(const FlowField &field, float x, float z) const
+{
+    int bx = block(x);
+    int bz = block(z);
+
+    return field.distance(bx, bz) == 0
+            && std::fabs(x - bx) <= AGENT_RADIUS && std::fabs(z - bz) <= AGENT_RADIUS;
+}
+
+/**
+ * @brief Crowd::agentBox returns the box of a walker at (x, z)
+ */
+BoundingBox Crowd::agentBox(float x, float z)
+{
+    return BoundingBox(QVector3D(x - AGENT_RADIUS, -0.5f, z - AGENT_RADIUS)
+                       , QVector3D(x + AGENT_RADIUS, 2.f * AGENT_RADIUS - 0.5f, z + AGENT_RADIUS));
+}
+
+/**
+ * @brief Crowd::pressButton reports the box of a walker at (x, z) to the
+ * trigger system for the next tick
+ */
+void Crowd::pressButton(float x, float z)
+{
+    if (_triggers)
+        _triggers->touch(_actor, agentBox(x, z));
+}
+
+/**
+ * @brief Crowd::work runs on worker thread t; each generation started by
+ * step() it steps its share of the agents, if it has one
+ */
+void Crowd::work(unsigned int t)
+{
+    unsigned int seen = 0;
+
+    for (;;)
+    {
+        unsigned int threads;
+        float dt;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [&] { return _stopping || _generation != seen; });
+
+            if (_stopping)
+                return;
+
+            seen = _generation;
+            threads = _threads;
+            dt = _dt;
+        }
+
+        if (t >= threads)
+            continue;
+
+        unsigned int count = size();
+
+        stepRange(count * t / threads, count * (t + 1) / threads, dt);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (--_pending == 0)
+                _done.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Crowd::step advances all agents by elapsedMilli, spread over all
+ * cores once there are enough of them
+ */
+void Crowd::step(float elapsedMilli)
+{
+    unsigned int count = size();
+
+    if (count == 0)
+        return;
+
+    bin();
+
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int threads = std::max(1u, std::min(cores, count / MIN_AGENTS_PER_THREAD));
+
+    /** The pool is started once and then reused every step */
+    if (threads > 1 && _workers.empty())
+        for (unsigned int t = 1; t < cores; t++)
+            _workers.emplace_back(&Crowd::work, this, t);
+
+    if (threads > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _threads = threads;
+            _dt = elapsedMilli;
+            _pending = threads - 1;
+            _generation++;
+        }
+        _start.notify_all();
+
+        stepRange(0, count / threads, elapsedMilli);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _pending == 0; });
+    }
+    else
+    {
+        stepRange(0, count, elapsedMilli);
+    }
+
+    _posX.swap(_nextX);
+    _posZ.swap(_nextZ);
+    _revision++;
+
+    /** Reaching a button switches to the goal field, a goal respawns */
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (!_arrived[i])
+            continue;
+
+        if (_phase[i] == 0)
+        {
+            pressButton(_posX[i], _posZ[i]);
+            _phase[i] = 1;
+        }
+        else
+        {
+            _posX[i] = _spawnX[i];
+            _posZ[i] = _spawnZ[i];
+            _phase[i] = 0;
+        }
+    }
+}
+
+void Crowd::serialize(QDataStream &ds) const
+{
+    ds << static_cast<quint32> (size());
+
+    for (unsigned int i = 0; i < size(); i++)
+        ds << _posX[i] << _posZ[i] << _phase[i];
+}
+
+void Crowd::deserialize(QDataStream &ds)
+{
+    quint32 count;
+
+    ds >> count;
+    _posX.resize(count);
+    _posZ.resize(count);
+    _phase.resize(count);
+
+    for (unsigned int i = 0; i < count; i++)
+        ds >> _posX[i] >> _posZ[i] >> _phase[i];
+
+    _revision++;
+}
+
+void Crowd::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (size() == 0)
+        return;
+
+    /** Further windows of the frame draw what the first one uploaded */
+    if (_uploadedRevision != _revision)
+    {
+        _instances.resize(4 * static_cast<size_t> (size()));
+
+        for (unsigned int i = 0; i < size(); i++)
+        {
+            _instances[4 * i + 0] = _posX[i];
+            _instances[4 * i + 1] = AGENT_RADIUS - 0.5f;
+            _instances[4 * i + 2] = _posZ[i];
+            _instances[4 * i + 3] = _phase[i];
+        }
+
+        /** Orphan the buffer so the upload does not wait for the last frame */
+        f->glBindBuffer(GL_ARRAY_BUFFER, _instanceBuf);
+        f->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr> (_instances.size() * sizeof(float))
+                        , nullptr, GL_STREAM_DRAW);
+        f->glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr> (_instances.size() * sizeof(float))
+                           , _instances.data());
+        _uploadedRevision = _revision;
+    }
+
+    queue.push(DrawItem(&getShader(), nullptr, getVao()
+                        , GL_TRIANGLES, _indexCount, GL_UNSIGNED_SHORT, getModelMatrix()
+                        , QVector3D(), static_cast<GLsizei> (size())));
+}
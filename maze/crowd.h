@@ -0,0 +1,90 @@
+#ifndef CROWD_H
+#define CROWD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QDataStream>
+#include <drawable.h>
+#include <triggersystem.h>
+#include <bitgrid.h>
+#include <flowfield.h>
+
+/**
+ * @brief The Crowd class simulates autonomous walkers in the maze and draws
+ * them as instanced boxes
+ *
+ * Walkers follow one flow field to the nearest button, press it, then follow
+ * a second one to the nearest goal, where they start over from their spawn
+ * position. They collide with the walls of the grid and push each other
+ * apart. Agent state is kept as separate arrays and stepped in parallel by
+ * a pool of worker threads that lives as long as the crowd; positions are
+ * double buffered so that every walker sees the others as they were at the
+ * start of the step.
+ */
+class Crowd : public Drawable
+{
+public:
+    Crowd(const BitGrid &open, FlowField toButtons, FlowField toGoals);
+    ~Crowd();
+
+    void spawn(const std::vector<QVector3D> &positions);
+    void setTriggers(TriggerSystem &triggers);
+    void step(float elapsedMilli);
+    unsigned int size() const;
+    void serialize(QDataStream &ds) const;
+    void deserialize(QDataStream &ds);
+
+private:
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix) override;
+    void bin();
+    void stepRange(unsigned int first, unsigned int last, float dt);
+    void work(unsigned int t);
+    bool blocked(float x, float z) const;
+    bool arrived(const FlowField &field, float x, float z) const;
+    static BoundingBox agentBox(float x, float z);
+    void pressButton(float x, float z);
+
+    const BitGrid &_open;
+    FlowField _fields[2];
+    TriggerSystem *_triggers = nullptr;
+    unsigned int _actor = 0;         // all walkers share one trigger actor
+
+    /** Agent state */
+    std::vector<float> _posX;
+    std::vector<float> _posZ;
+    std::vector<float> _nextX;
+    std::vector<float> _nextZ;
+    std::vector<float> _spawnX;
+    std::vector<float> _spawnZ;
+    std::vector<uint8_t> _phase;     // index into _fields
+    std::vector<uint8_t> _arrived;   // set by stepRange when a target is reached
+
+    /** Agents sorted by block, for neighbour lookups */
+    std::vector<unsigned int> _cellStart;
+    std::vector<unsigned int> _cellFill;    // next free slot per block, while binning
+    std::vector<unsigned int> _sorted;
+
+    /** Worker t steps its share of the agents of generation _generation */
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    unsigned int _generation = 0;
+    unsigned int _pending = 0;       // workers not done with the generation
+    unsigned int _threads = 1;       // threads sharing the generation
+    float _dt = 0.f;
+    bool _stopping = false;
+
+    /** Agent state changes bump _revision; enqueue() uploads once per change */
+    unsigned int _revision = 1;
+    unsigned int _uploadedRevision = 0;
+    std::vector<float> _instances;
+    GLuint _instanceBuf = 0;
+    GLsizei _indexCount = 0;
+};
+
+#endif // CROWD_H
@@ -0,0 +1,8 @@
+flat in lowp vec3 vcolor;
+
+layout(location = 0) out vec4 fcolor;
+
+void main(void)
+{
+    fcolor = vec4(vcolor, 1.0);
+}
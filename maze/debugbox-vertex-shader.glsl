@@ -0,0 +1,22 @@
+$VIEWS
+
+layout(std140) uniform Camera
+{
+    mat4 view_matrices[MAX_VIEWS];
+    mat4 projection_matrices[MAX_VIEWS];
+};
+
+layout(location = 0) in vec4 pos;      // corner of the unit cube
+layout(location = 3) in vec3 boxMin;
+layout(location = 4) in vec3 boxMax;
+layout(location = 5) in vec3 boxColor;
+
+flat out vec3 vcolor;
+
+void main(void)
+{
+    mat4 view_matrix = view_matrices[VIEW_ID];
+    mat4 projection_matrix = projection_matrices[VIEW_ID];
+    vcolor = boxColor;
+    gl_Position = projection_matrix * view_matrix * vec4(mix(boxMin, boxMax, pos.xyz), 1.0);
+}
@@ -0,0 +1,212 @@
+#include <geometries.hpp>
+#include "debugboxrenderer.h"
+
+#define INSTANCE_FLOATS 9 // min xyz, max xyz, color rgb
+
+std::shared_ptr<DebugBoxRenderer> DebugBoxRenderer::instance()
+{
+    static std::shared_ptr<DebugBoxRenderer> renderer = std::make_shared<DebugBoxRenderer>();
+
+    return renderer;
+}
+
+DebugBoxRenderer::DebugBoxRenderer():
+    Drawable("Debug boxes")
+{
+    QVector3D p[8];
+
+    for (int i = 0; i < 8; i++)
+        p[i] = QVector3D(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+
+    /** Unit cube outline: 12 edges */
+    std::vector<QVector3D> edges = {
+        p[0], p[1], p[1], p[5], p[5], p[4], p[4], p[0]
+        , p[2], p[3], p[3], p[7], p[7], p[6], p[6], p[2]
+        , p[0], p[2], p[1], p[3], p[5], p[7], p[4], p[6]
+    };
+
+    /** Unit cube faces, from the [-1, 1] cube of the geometry helpers */
+    std::vector<float> positions, normals, texcoords;
+    std::vector<unsigned short> indices;
+
+    geom_cube(positions, normals, texcoords, indices);
+
+    std::vector<QVector3D> corners;
+
+    for (size_t i = 0; i < positions.size() / 3; i++)
+        corners.push_back(0.5f * QVector3D(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2])
+                          + QVector3D(0.5f, 0.5f, 0.5f));
+
+    initBatch(_lines, edges, nullptr);
+    initBatch(_solid, corners, &indices);
+    _lineVertices = static_cast<GLsizei> (edges.size());
+    _solidIndices = static_cast<GLsizei> (indices.size());
+
+    Drawable::loadShader(
+                ":debugbox-vertex-shader.glsl"
+                , ":debugbox-fragment-shader.glsl"
+                );
+}
+
+/**
+ * @brief DebugBoxRenderer::initBatch creates the VAO of one draw mode: the
+ * unit cube corners at attribute 0, per instance bounds and color at
+ * attributes 3 to 5
+ */
+void DebugBoxRenderer::initBatch(Batch &batch, const std::vector<QVector3D> &corners
+                                 , const std::vector<unsigned short> *indices)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    GLuint vertexBuf, indexBuf;
+    const GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+
+    f->glGenVertexArrays(1, &batch.vao);
+    f->glBindVertexArray(batch.vao);
+
+    f->glGenBuffers(1, &vertexBuf);
+    f->glBindBuffer(GL_ARRAY_BUFFER, vertexBuf);
+    f->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr> (corners.size() * sizeof(QVector3D)), corners.data(), GL_STATIC_DRAW);
+    f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    f->glEnableVertexAttribArray(0);
+
+    if (indices)
+    {
+        f->glGenBuffers(1, &indexBuf);
+        f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf);
+        f->glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr> (indices->size() * sizeof(unsigned short)), indices->data(), GL_STATIC_DRAW);
+    }
+
+    f->glGenBuffers(1, &batch.instanceBuf);
+    f->glBindBuffer(GL_ARRAY_BUFFER, batch.instanceBuf);
+
+    for (GLuint i = 0; i < 3; i++)
+    {
+        f->glVertexAttribPointer(3 + i, 3, GL_FLOAT, GL_FALSE, stride
+                                 , reinterpret_cast<const void *> (3 * i * sizeof(float)));
+        f->glVertexAttribDivisor(3 + i, 1);
+        f->glEnableVertexAttribArray(3 + i);
+    }
+
+    f->glBindVertexArray(0);
+    f->glDeleteBuffers(1, &vertexBuf);
+
+    if (indices)
+        f->glDeleteBuffers(1, &indexBuf);
+}
+
+/**
+ * @brief DebugBoxRenderer::add starts drawing the bounds of collider, as
+ * outline; returns the id for setSolid and remove
+ */
+unsigned int DebugBoxRenderer::add(const Collider *collider, QVector3D color)
+{
+    Entry entry = {collider, color, false, collider->getTransformRevision()};
+    unsigned int id;
+
+    if (_free.empty())
+    {
+        id = static_cast<unsigned int> (_entries.size());
+        _entries.push_back(entry);
+    }
+    else
+    {
+        id = _free.back();
+        _free.pop_back();
+        _entries[id] = entry;
+    }
+
+    _size++;
+    _changed = true;
+
+    return id;
+}
+
+void DebugBoxRenderer::remove(unsigned int id)
+{
+    _entries.at(id).collider = nullptr;
+    _free.push_back(id);
+    _size--;
+    _changed = true;
+}
+
+void DebugBoxRenderer::setSolid(unsigned int id, bool solid)
+{
+    Entry &entry = _entries.at(id);
+
+    _changed |= entry.solid != solid;
+    entry.solid = solid;
+}
+
+unsigned int DebugBoxRenderer::size() const
+{
+    return _size;
+}
+
+void DebugBoxRenderer::upload(Batch &batch)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    GLsizeiptr bytes = static_cast<GLsizeiptr> (batch.instances.size() * sizeof(float));
+
+    batch.count = static_cast<GLsizei> (batch.instances.size() / INSTANCE_FLOATS);
+
+    if (batch.count == 0)
+        return;
+
+    /** Orphan the buffer so the upload does not wait for the last frame */
+    f->glBindBuffer(GL_ARRAY_BUFFER, batch.instanceBuf);
+    f->glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    f->glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, batch.instances.data());
+}
+
+/**
+ * @brief DebugBoxRenderer::endFrame uploads the boxes for all windows of the
+ * coming frame if any of them changed since the last upload
+ */
+void DebugBoxRenderer::endFrame()
+{
+    for (Entry &entry : _entries)
+    {
+        if (!entry.collider || entry.revision == entry.collider->getTransformRevision())
+            continue;
+
+        entry.revision = entry.collider->getTransformRevision();
+        _changed = true;
+    }
+
+    if (!_changed)
+        return;
+
+    _lines.instances.clear();
+    _solid.instances.clear();
+
+    for (const Entry &entry : _entries)
+    {
+        if (!entry.collider)
+            continue;
+
+        BoundingBox box = entry.collider->getBox();
+        std::vector<float> &instances = entry.solid ? _solid.instances : _lines.instances;
+        const float data[INSTANCE_FLOATS] = {
+            box.a.x(), box.a.y(), box.a.z()
+            , box.b.x(), box.b.y(), box.b.z()
+            , entry.color.x(), entry.color.y(), entry.color.z()
+        };
+
+        instances.insert(instances.end(), data, data + INSTANCE_FLOATS);
+    }
+
+    upload(_lines);
+    upload(_solid);
+    _changed = false;
+}
+
+void DebugBoxRenderer::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
+{
+    if (_lines.count > 0)
+        queue.push(DrawItem(&getShader(), nullptr, _lines.vao
+                            , GL_LINES, _lineVertices, 0, QMatrix4x4(), QVector3D(), _lines.count));
+
+    if (_solid.count > 0)
+        queue.push(DrawItem(&getShader(), nullptr, _solid.vao
+                            , GL_TRIANGLES, _solidIndices, GL_UNSIGNED_SHORT, QMatrix4x4(), QVector3D(), _solid.count));
+}
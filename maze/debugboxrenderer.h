@@ -0,0 +1,63 @@
+#ifndef DEBUGBOXRENDERER_H
+#define DEBUGBOXRENDERER_H
+
+#include <memory>
+#include <vector>
+#include <drawable.h>
+#include <collider.h>
+
+/**
+ * @brief The DebugBoxRenderer class draws the bounds of colliders, all of
+ * them with one program and one instanced draw call per mode
+ *
+ * Boxes are drawn as outlines or, while setSolid is on, as solid cubes.
+ * endFrame(), called once per frame before rendering, reads the bounds of
+ * the colliders whose transform revision changed, so moving colliders need
+ * no extra bookkeeping, and uploads the instances only when a box was
+ * added, removed or changed. There is one renderer per process, see
+ * instance().
+ */
+class DebugBoxRenderer : public Drawable
+{
+public:
+    static std::shared_ptr<DebugBoxRenderer> instance();
+
+    DebugBoxRenderer();
+
+    unsigned int add(const Collider *collider, QVector3D color);
+    void remove(unsigned int id);
+    void setSolid(unsigned int id, bool solid);
+    unsigned int size() const;
+    void endFrame();
+
+private:
+    struct Entry {
+        const Collider *collider;
+        QVector3D color;
+        bool solid;
+        unsigned int revision;  // of the collider, when its box was last read
+    };
+
+    struct Batch {
+        GLuint vao = 0;
+        GLuint instanceBuf = 0;
+        std::vector<float> instances;
+        GLsizei count = 0;      // uploaded instances
+    };
+
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix) override;
+    void initBatch(Batch &batch, const std::vector<QVector3D> &corners
+            , const std::vector<unsigned short> *indices);
+    void upload(Batch &batch);
+
+    std::vector<Entry> _entries;
+    std::vector<unsigned int> _free;
+    unsigned int _size = 0;
+    bool _changed = false;      // entries were added, removed or switched mode
+    Batch _lines;
+    Batch _solid;
+    GLsizei _lineVertices = 0;
+    GLsizei _solidIndices = 0;
+};
+
+#endif // DEBUGBOXRENDERER_H
@@ -0,0 +1,21 @@
+$VIEWS
+
+layout(std140) uniform Camera
+{
+    mat4 view_matrices[MAX_VIEWS];
+    mat4 projection_matrices[MAX_VIEWS];
+};
+
+layout(location = 0) in vec4 pos;
+layout(location = 1) in vec3 color;
+
+flat out vec3 vcolor;
+
+void main(void)
+{
+    mat4 view_matrix = view_matrices[VIEW_ID];
+    mat4 projection_matrix = projection_matrices[VIEW_ID];
+    vcolor = color;
+    gl_PointSize = 4.0;
+    gl_Position = projection_matrix * view_matrix * pos;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include "debugdraw.h"
+
+#define VERTEX_FLOATS 6 // position xyz, color rgb
+#define FENCE_TIMEOUT 1000000000 // ns
+
+std::shared_ptr<DebugDraw> DebugDraw::instance()
+{
+    static std::shared_ptr<DebugDraw> draw = std::make_shared<DebugDraw>();
+
+    return draw;
+}
+
+DebugDraw::DebugDraw():
+    Drawable("Debug draw")
+{
+    initBatch(_lines, GL_LINES);
+    initBatch(_points, GL_POINTS);
+
+#ifdef GL_PROGRAM_POINT_SIZE
+    /** Desktop GL ignores gl_PointSize unless asked to; GLES always uses it */
+    if (!Drawable::getGLES())
+        QOpenGLContext::currentContext()->extraFunctions()->glEnable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    Drawable::loadShader(
+                ":debugdraw-vertex-shader.glsl"
+                , ":debugbox-fragment-shader.glsl"
+                );
+}
+
+void DebugDraw::initBatch(Batch &batch, GLenum mode)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    batch.mode = mode;
+    f->glGenVertexArrays(1, &batch.vao);
+    f->glGenBuffers(1, &batch.vertexBuf);
+    f->glBindVertexArray(batch.vao);
+    f->glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuf);
+    f->glEnableVertexAttribArray(0);
+    f->glEnableVertexAttribArray(1);
+    f->glBindVertexArray(0);
+}
+
+void DebugDraw::vertex(Batch &batch, QVector3D p, QVector3D color)
+{
+    const float data[VERTEX_FLOATS] = {
+        p.x(), p.y(), p.z()
+        , color.x(), color.y(), color.z()
+    };
+
+    batch.vertices.insert(batch.vertices.end(), data, data + VERTEX_FLOATS);
+}
+
+void DebugDraw::line(QVector3D a, QVector3D b, QVector3D color)
+{
+    vertex(_lines, a, color);
+    vertex(_lines, b, color);
+}
+
+/**
+ * @brief DebugDraw::path draws the segments between consecutive points
+ */
+void DebugDraw::path(const std::vector<QVector3D> &points, QVector3D color)
+{
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        vertex(_lines, points[i - 1], color);
+        vertex(_lines, points[i], color);
+    }
+}
+
+void DebugDraw::box(const BoundingBox &box, QVector3D color)
+{
+    QVector3D p[8];
+
+    for (int i = 0; i < 8; i++)
+        p[i] = QVector3D(i & 1 ? box.b.x() : box.a.x()
+                         , i & 2 ? box.b.y() : box.a.y()
+                         , i & 4 ? box.b.z() : box.a.z());
+
+    /** 12 edges, as pairs of corner indices */
+    static const int edges[24] = {
+        0, 1, 1, 5, 5, 4, 4, 0
+        , 2, 3, 3, 7, 7, 6, 6, 2
+        , 0, 2, 1, 3, 5, 7, 4, 6
+    };
+
+    for (int i = 0; i < 24; i++)
+        vertex(_lines, p[edges[i]], color);
+}
+
+void DebugDraw::point(QVector3D p, QVector3D color)
+{
+    vertex(_points, p, color);
+}
+
+/**
+ * @brief DebugDraw::upload copies the vertices of batch into the current
+ * ring segment and points the VAO at it
+ */
+void DebugDraw::upload(Batch &batch)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+    unsigned int count = static_cast<unsigned int> (batch.vertices.size() / VERTEX_FLOATS);
+
+    batch.count = static_cast<GLsizei> (count);
+
+    if (count == 0)
+        return;
+
+    f->glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuf);
+
+    if (count > batch.capacity)
+    {
+        /** Reallocating orphans the storage the GPU may still read */
+        batch.capacity = std::max(count, 2 * batch.capacity);
+        f->glBufferData(GL_ARRAY_BUFFER, DEBUG_SEGMENTS * batch.capacity * stride, nullptr, GL_STREAM_DRAW);
+    }
+
+    GLintptr offset = _segment * batch.capacity * stride;
+    void *data = f->glMapBufferRange(GL_ARRAY_BUFFER, offset, count * stride
+                                     , GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    if (!data)
+    {
+        batch.count = 0;
+        return;
+    }
+
+    std::memcpy(data, batch.vertices.data(), count * stride);
+    f->glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    f->glBindVertexArray(batch.vao);
+    f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void *> (offset));
+    f->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride
+                             , reinterpret_cast<const void *> (offset + 3 * sizeof(float)));
+    f->glBindVertexArray(0);
+}
+
+/**
+ * @brief DebugDraw::endFrame uploads the primitives added since the last
+ * call into the next ring segment and starts collecting a new frame; call it
+ * once per frame, before the windows are rendered
+ */
+void DebugDraw::endFrame()
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    /** Every draw of the last segment has been issued by now */
+    if (_fences[_segment])
+        f->glDeleteSync(_fences[_segment]);
+    _fences[_segment] = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _segment = (_segment + 1) % DEBUG_SEGMENTS;
+
+    GLsync &fence = _fences[_segment];
+
+    if (fence)
+    {
+        while (f->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+            ;
+        f->glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    upload(_lines);
+    upload(_points);
+    _lines.vertices.clear();
+    _points.vertices.clear();
+}
+
+void DebugDraw::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
+{
+    /** Every window draws the segment endFrame() uploaded */
+    for (const Batch *batch : {&_lines, &_points})
+        if (batch->count > 0)
+            queue.push(DrawItem(&getShader(), nullptr, batch->vao, batch->mode, batch->count, 0, QMatrix4x4()));
+}
@@ -0,0 +1,57 @@
+#ifndef DEBUGDRAW_H
+#define DEBUGDRAW_H
+
+#include <memory>
+#include <vector>
+#include <drawable.h>
+#include <boundingbox.h>
+
+#define DEBUG_SEGMENTS 3
+
+/**
+ * @brief The DebugDraw class collects lines, boxes and points from anywhere
+ * in a frame and draws them with one call per primitive type
+ *
+ * Primitives are kept in CPU arrays until endFrame(), called once per frame
+ * before rendering, uploads them into one of DEBUG_SEGMENTS segments of a
+ * vertex ring and clears the arrays for the next frame; every window then
+ * draws that segment. Primitives added while rendering thus show up one
+ * frame later. A fence per segment keeps the upload from overwriting
+ * vertices the GPU still reads. There is one instance per process, see
+ * instance().
+ */
+class DebugDraw : public Drawable
+{
+public:
+    static std::shared_ptr<DebugDraw> instance();
+
+    DebugDraw();
+
+    void line(QVector3D a, QVector3D b, QVector3D color);
+    void path(const std::vector<QVector3D> &points, QVector3D color);
+    void box(const BoundingBox &box, QVector3D color);
+    void point(QVector3D p, QVector3D color);
+    void endFrame();
+
+private:
+    struct Batch {
+        GLuint vao = 0;
+        GLuint vertexBuf = 0;
+        GLenum mode = GL_LINES;
+        unsigned int capacity = 0;  // vertices per segment
+        GLsizei count = 0;          // vertices in the current segment
+        std::vector<float> vertices;
+    };
+
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix) override;
+    void initBatch(Batch &batch, GLenum mode);
+    void vertex(Batch &batch, QVector3D p, QVector3D color);
+    void upload(Batch &batch);
+
+    Batch _lines;
+    Batch _points;
+    unsigned int _segment = 0;
+    GLsync _fences[DEBUG_SEGMENTS] = {};
+};
+
+#endif // DEBUGDRAW_H
@@ -1,3 +1,4 @@
+#include <shadercache.h>
 #include "drawable.h"
 #define ANIMATION_SPEED 0.01f
 
@@ -7,6 +8,9 @@ Drawable::Drawable(std::string name): _name(name)
 
 void Drawable::update(QMatrix4x4 transform, float elapsedMilli)
 {
+    if (_globalTransform != transform || !_offset.isNull())
+        transformChanged();
+
     _globalTransform = transform;
     _localTransform.translate(_offset);
 
@@ -16,6 +20,9 @@ void Drawable::update(QMatrix4x4 transform, float elapsedMilli)
 
 void Drawable::setLocalTransform(QMatrix4x4 m)
 {
+    if (_localTransform != m)
+        transformChanged();
+
     _localTransform = m;
 
     for (std::shared_ptr<Drawable> child : _children)
@@ -24,55 +31,73 @@ void Drawable::setLocalTransform(QMatrix4x4 m)
 
 void Drawable::setGlobalTransform(QMatrix4x4 m)
 {
+    if (_globalTransform != m)
+        transformChanged();
+
     _globalTransform = m;
 
     for (std::shared_ptr<Drawable> child : _children)
         child->setGlobalTransform(m);
 }
 
-void Drawable::render(QMatrix4x4 &vMatrix, QMatrix4x4 &pMatrix)
+/**
+ * @brief Drawable::collect appends the draw items of this drawable and all
+ * its descendants to queue
+ */
+void Drawable::collect(RenderQueue &queue, const QMatrix4x4 &vMatrix)
 {
-    for (std::shared_ptr<Drawable> child : _children)
-        child->render(vMatrix, pMatrix);
+    for (const std::shared_ptr<Drawable> &child : _children)
+        child->collect(queue, vMatrix);
 
-    glRender(vMatrix, pMatrix);
+    enqueue(queue, vMatrix);
 }
 
-void Drawable::glRender(QMatrix4x4 &vMatrix, QMatrix4x4 &pMatrix)
+void Drawable::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
 {
-    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
-
-    _prg.bind();
+    if (_vao == 0 || !_prg)
+        return;
 
-    f->glActiveTexture(GL_TEXTURE0);
-    f->glBindTexture(GL_TEXTURE_2D, _material.diffTex);
-    f->glActiveTexture(GL_TEXTURE1);
-    f->glBindTexture(GL_TEXTURE_2D, _material.normTex);
-    f->glActiveTexture(GL_TEXTURE2);
-    f->glBindTexture(GL_TEXTURE_2D, _material.specTex);
-
-    // Projection
-    QMatrix4x4 modelViewMatrix = vMatrix * _globalTransform * _localTransform;
-    _prg.setUniformValue("model_view_matrix", modelViewMatrix);
-    _prg.setUniformValue("projection_model_view_matrix", pMatrix * modelViewMatrix);
-    _prg.setUniformValue("normal_matrix", modelViewMatrix.normalMatrix());
-    f->glBindVertexArray(_vao);
-    f->glDrawElements(GL_TRIANGLES, _elementsCount, GL_UNSIGNED_SHORT, nullptr);
-
-    _prg.release();
+    queue.push(DrawItem(_prg.get(), &_material, _vao
+                        , GL_TRIANGLES, _elementsCount, _indexType, getModelMatrix()));
 }
 
 void Drawable::initBuffers(std::vector<QVector3D> *vertices
                            , std::vector<QVector3D> *normals
                            , std::vector<QVector2D> *texcoords
                            , std::vector<unsigned short> *indices)
+{
+    _vao = createVao(vertices, normals, texcoords
+                     , indices->data(), indices->size(), GL_UNSIGNED_SHORT);
+    _elementsCount = static_cast<GLsizei> (indices->size());
+    _indexType = GL_UNSIGNED_SHORT;
+}
+
+void Drawable::initBuffers(std::vector<QVector3D> *vertices
+                           , std::vector<QVector3D> *normals
+                           , std::vector<QVector2D> *texcoords
+                           , std::vector<unsigned int> *indices)
+{
+    _vao = createVao(vertices, normals, texcoords
+                     , indices->data(), indices->size(), GL_UNSIGNED_INT);
+    _elementsCount = static_cast<GLsizei> (indices->size());
+    _indexType = GL_UNSIGNED_INT;
+}
+
+/**
+ * @brief Drawable::createVao uploads the vertex attributes and indices into a
+ * new vertex array object; the buffers live as long as the VAO does
+ */
+GLuint Drawable::createVao(std::vector<QVector3D> *vertices
+                           , std::vector<QVector3D> *normals
+                           , std::vector<QVector2D> *texcoords
+                           , const void *indices, size_t indexCount, GLenum indexType)
 {
     QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
 
-    GLuint positionBuf, normalBuf, texcoordBuf, indexBuf;
+    GLuint vao, positionBuf, normalBuf, texcoordBuf, indexBuf;
 
-    f->glGenVertexArrays(1, &_vao);
-    f->glBindVertexArray(_vao);
+    f->glGenVertexArrays(1, &vao);
+    f->glBindVertexArray(vao);
 
     f->glGenBuffers(1, &positionBuf);
     f->glBindBuffer(GL_ARRAY_BUFFER, positionBuf);
@@ -94,7 +119,7 @@ void Drawable::initBuffers(std::vector<QVector3D> *vertices
 
     f->glGenBuffers(1, &indexBuf);
     f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf);
-    f->glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr> (indices->size() * sizeof(unsigned short)), indices->data(), GL_STATIC_DRAW);
+    f->glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr> (indexCount * (indexType == GL_UNSIGNED_INT ? sizeof(unsigned int) : sizeof(unsigned short))), indices, GL_STATIC_DRAW);
 
     f->glBindVertexArray(0);
 
@@ -103,7 +128,7 @@ void Drawable::initBuffers(std::vector<QVector3D> *vertices
     f->glDeleteBuffers(1, &texcoordBuf);
     f->glDeleteBuffers(1, &indexBuf);
 
-    _elementsCount = static_cast<GLsizei> (indices->size());
+    return vao;
 }
 
 void Drawable::addChild(std::shared_ptr<Drawable> child)
@@ -111,15 +136,18 @@ void Drawable::addChild(std::shared_ptr<Drawable> child)
    _children.push_back(child);
 }
 
-unsigned int Drawable::loadTexture(const QString& filename)
+/**
+ * @brief Drawable::loadTexture returns the shared texture of filename, which
+ * shows placeholder until it is loaded; the drawable holds it as long as it
+ * lives
+ */
+unsigned int Drawable::loadTexture(const QString& filename, QRgb placeholder)
 {
-    QImage img;
-    img.load(filename);
-    if (getGLES())
-        img = img.scaledToWidth(img.width() / 2, Qt::SmoothTransformation);
-    img = img.mirrored(false, true);
-    img = img.convertToFormat(QImage::Format_RGBA8888);
-    return loadTexture(img);
+    std::shared_ptr<Texture> texture = TextureCache::texture(filename, getGLES(), placeholder);
+
+    _textures.push_back(texture);
+
+    return texture->name();
 }
 
 unsigned int Drawable::loadTexture(const QImage& img)
@@ -147,23 +175,6 @@ unsigned int Drawable::loadTexture(const QImage& img)
 void Drawable::setMaterial(const Material m)
 {
     _material = m;
-
-    _prg.bind();
-
-    // Material
-    _prg.setUniformValue("material_color", m.r, m.g, m.b);
-    _prg.setUniformValue("material_kd", m.kd);
-    _prg.setUniformValue("material_ks", m.ks);
-    _prg.setUniformValue("material_shininess", m.shininess);
-    _prg.setUniformValue("material_has_diff_tex", m.diffTex == 0 ? 0 : 1);
-    _prg.setUniformValue("material_diff_tex", 0);
-    _prg.setUniformValue("material_has_norm_tex", m.normTex == 0 ? 0 : 1);
-    _prg.setUniformValue("material_norm_tex", 1);
-    _prg.setUniformValue("material_has_spec_tex", m.specTex == 0 ? 0 : 1);
-    _prg.setUniformValue("material_spec_tex", 2);
-    _prg.setUniformValue("material_tex_coord_factor", m.texCoordFactor);
-
-    _prg.release();
 }
 
 QString Drawable::readFile(const char* fileName)
@@ -190,14 +201,27 @@ void Drawable::loadShader(const char* vertShaderPath, const char* fragShaderPath
         fragmentShaderSource.replace("$WITH_NORMAL_MAPS", "1");
         fragmentShaderSource.replace("$WITH_SPEC_MAPS", "1");
     }
-    _prg.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource);
-    _prg.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
-    _prg.link();
+
+    /** View defines: one view per draw, or with GL_OVR_multiview2 all
+     *  MAX_VIEWS views of a layered framebuffer, indexed by gl_ViewID_OVR */
+    const QString views = QString("#define MAX_VIEWS %1\n").arg(MAX_VIEWS);
+
+    _prg = ShaderCache::program(
+                QString(vertexShaderSource).replace("$VIEWS", views + "#define VIEW_ID 0\n")
+                , fragmentShaderSource);
+
+    if (getMultiview())
+        ShaderCache::setMultiview(_prg.get(), ShaderCache::program(
+                QString(vertexShaderSource).replace("$VIEWS"
+                        , QString("#extension GL_OVR_multiview2 : require\n"
+                                  "layout(num_views = %1) in;\n").arg(MAX_VIEWS)
+                        + views + "#define VIEW_ID int(gl_ViewID_OVR)\n")
+                , fragmentShaderSource));
 }
 
 QOpenGLShaderProgram& Drawable::getShader()
 {
-    return _prg;
+    return *_prg;
 }
 
 GLuint Drawable::getVao()
@@ -215,11 +239,32 @@ QMatrix4x4 Drawable::getModelMatrix() const
     return _globalTransform * _localTransform;
 }
 
+const Material &Drawable::getMaterial() const
+{
+    return _material;
+}
+
 QMatrix4x4 Drawable::getLocalTransform() const
 {
     return _localTransform;
 }
 
+/**
+ * @brief Drawable::getTransformRevision changes whenever the model matrix does
+ *
+ * Lets dependants cache values derived from the model matrix and refresh them
+ * only when the revision they saw is outdated.
+ */
+unsigned int Drawable::getTransformRevision() const
+{
+    return _transformRevision;
+}
+
+void Drawable::transformChanged()
+{
+    _transformRevision++;
+}
+
 void Drawable::setGLES(bool isGLES)
 {
     Drawable::isGLES = isGLES;
@@ -232,6 +277,22 @@ bool Drawable::getGLES()
 
 bool Drawable::isGLES = false;
 
+/**
+ * @brief Drawable::setMultiview makes loadShader build multiview variants of
+ * all programs loaded afterwards; only set when GL_OVR_multiview2 is there
+ */
+void Drawable::setMultiview(bool multiview)
+{
+    Drawable::multiview = multiview;
+}
+
+bool Drawable::getMultiview()
+{
+    return Drawable::multiview;
+}
+
+bool Drawable::multiview = false;
+
 void Drawable::move(QVector3D offset)
 {
     _offset = offset;
@@ -10,6 +10,8 @@
 #include <memory>
 #include <iostream>
 #include <material.h>
+#include <renderqueue.h>
+#include <texturecache.h>
 
 class Drawable : protected QOpenGLExtraFunctions
 {
@@ -18,40 +20,61 @@ public:
     void update(QMatrix4x4 m, float elapsedMilli);
     void setGlobalTransform(QMatrix4x4 m);
     void setLocalTransform(QMatrix4x4 m);
-    void render(QMatrix4x4 &vMatrix, QMatrix4x4 &pMatrix);
+    void collect(RenderQueue &queue, const QMatrix4x4 &vMatrix);
     void addChild(std::shared_ptr<Drawable> child);
     void setMaterial(const Material material);
     virtual void initBuffers(  std::vector<QVector3D> *vertices
                      , std::vector<QVector3D> *normals
                      , std::vector<QVector2D> *texcoords
                      , std::vector<unsigned short> *indices);
+    void initBuffers(  std::vector<QVector3D> *vertices
+                     , std::vector<QVector3D> *normals
+                     , std::vector<QVector2D> *texcoords
+                     , std::vector<unsigned int> *indices);
     QOpenGLShaderProgram& getShader();
     GLuint getVao();
     void setVao(GLuint vao);
     void loadShader(const char* vertShaderPath, const char* fragShaderPath);
-    unsigned int loadTexture(const QString& filename);
+    unsigned int loadTexture(const QString& filename
+                             , QRgb placeholder = TEXTURE_PLACEHOLDER_DIFFUSE);
     unsigned int loadTexture(const QImage& img);
     static QString readFile(const char* fileName);
     static void setGLES(bool isGLES);
     static bool getGLES();
+    static void setMultiview(bool multiview);
+    static bool getMultiview();
     static bool isGLES;
     void move(QVector3D offset);
     QMatrix4x4 getModelMatrix() const;
     QMatrix4x4 getLocalTransform() const;
+    unsigned int getTransformRevision() const;
+
+protected:
+    GLuint createVao(  std::vector<QVector3D> *vertices
+                     , std::vector<QVector3D> *normals
+                     , std::vector<QVector2D> *texcoords
+                     , const void *indices, size_t indexCount, GLenum indexType);
+    const Material &getMaterial() const;
 
 private:
-    virtual void glRender(QMatrix4x4 &vMatrix, QMatrix4x4 &pMatrix);
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix);
+    void transformChanged();
+
+    static bool multiview;
 
-    QOpenGLShaderProgram _prg;
+    std::shared_ptr<QOpenGLShaderProgram> _prg;
     std::vector<std::shared_ptr<Drawable>> _children;
     std::string _name;
     Material _material;
+    std::vector<std::shared_ptr<Texture>> _textures;
     QMatrix4x4 _globalTransform;
     QMatrix4x4 _localTransform;
     float _a = 0.f;
-    GLsizei _elementsCount;
+    GLsizei _elementsCount = 0;
+    GLenum _indexType = GL_UNSIGNED_SHORT;
     QVector3D _offset = QVector3D();
-    unsigned int _vao;
+    unsigned int _transformRevision = 0;
+    unsigned int _vao = 0;
 };
 
 #endif // DRAWABLE_H
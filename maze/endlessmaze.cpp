@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <cmath>
+#include <mazemesh.h>
+#include <frustum.h>
+#include "endlessmaze.h"
+
+#define CHUNK_UPLOADS_PER_FRAME 2
+#define MAX_CPU_CHUNKS 4096
+
+static uint64_t chunkKey(int cx, int cy)
+{
+    return (static_cast<uint64_t> (static_cast<uint32_t> (cx)) << 32) | static_cast<uint32_t> (cy);
+}
+
+static int chunkX(uint64_t key)
+{
+    return static_cast<int32_t> (static_cast<uint32_t> (key >> 32));
+}
+
+static int chunkY(uint64_t key)
+{
+    return static_cast<int32_t> (static_cast<uint32_t> (key));
+}
+
+static int floorDiv(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/** Chunk coordinate of a maze space coordinate; blocks are centred on integers */
+static int chunkOf(float coordinate)
+{
+    return floorDiv(static_cast<int> (std::floor(coordinate + 0.5f)), CHUNK_BLOCKS);
+}
+
+EndlessMaze::EndlessMaze(uint64_t seed, int radius, size_t gpuBudget) :
+    Drawable("EndlessMaze"), _seed(seed), _radius(radius), _gpuBudget(gpuBudget)
+{
+    Drawable::loadShader(
+                ":maze-vertex-shader.glsl"
+                , ":maze-fragment-shader.glsl"
+                );
+    Drawable::setMaterial(
+                Material(0.5f, 0.5f, 0.5f, 1.0f, 0.2f, 0.1f,
+                         loadTexture(":floor-diff.jpg")
+                         , getGLES() ? 0 : loadTexture(":floor-norm.jpg", TEXTURE_PLACEHOLDER_NORMAL), 0, 10.0f
+                         )
+                );
+}
+
+EndlessMaze::Chunk &EndlessMaze::chunkAt(int cx, int cy)
+{
+    uint64_t key = chunkKey(cx, cy);
+    auto it = _chunks.find(key);
+
+    if (it != _chunks.end())
+        return it->second;
+
+    /** Never evicts: callers keep references across further lookups */
+    Chunk &chunk = _chunks[key];
+
+    generateChunk(_seed, cx, cy, chunk.blocks);
+
+    return chunk;
+}
+
+/**
+ * @brief EndlessMaze::isOpen tells whether the block at global block
+ * coordinates (x, y) can be walked on
+ */
+bool EndlessMaze::isOpen(int x, int y)
+{
+    int cx = floorDiv(x, CHUNK_BLOCKS);
+    int cy = floorDiv(y, CHUNK_BLOCKS);
+    Chunk &chunk = chunkAt(cx, cy);
+
+    return chunk.blocks.get(x - cx * CHUNK_BLOCKS, y - cy * CHUNK_BLOCKS);
+}
+
+QVector3D EndlessMaze::getRandomPos() const
+{
+    /** Block (0, 0) is a maze cell and therefore always open */
+    return QVector3D(0.f, 0.f, 0.f) * getModelMatrix();
+}
+
+QVector3D EndlessMaze::collision(QVector3D position, QVector3D movement, BoundingBox observerBox)
+{
+    BoundingBox moved = BoundingBox(observerBox.a + movement, observerBox.b + movement);
+    int x0 = static_cast<int> (std::floor(std::min(observerBox.a.x(), moved.a.x()) + 0.5f));
+    int x1 = static_cast<int> (std::floor(std::max(observerBox.b.x(), moved.b.x()) + 0.5f));
+    int y0 = static_cast<int> (std::floor(std::min(observerBox.a.z(), moved.a.z()) + 0.5f));
+    int y1 = static_cast<int> (std::floor(std::max(observerBox.b.z(), moved.b.z()) + 0.5f));
+
+    /** Solid blocks along the way become the colliders of this query */
+    _store.clear();
+    _blockers.clear();
+
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++)
+            if (!isOpen(x, y))
+                _blockers.push_back(_store.add(BoundingBox(
+                                                   QVector3D(x - 0.5f, -0.5f, y - 0.5f)
+                                                   , QVector3D(x + 0.5f, 0.5f, y + 0.5f))));
+
+    return position + slideMove(observerBox, movement
+                                , [this](const BoundingBox &box, QVector3D m)
+    {
+        return _store.sweep(box, m, _blockers.data(), static_cast<unsigned int> (_blockers.size()));
+    });
+}
+
+void EndlessMaze::setGpuBudget(size_t bytes)
+{
+    _gpuBudget = bytes;
+    evict();
+}
+
+size_t EndlessMaze::getGpuBytes() const
+{
+    return _gpuBytes;
+}
+
+void EndlessMaze::upload(Chunk &chunk, int cx, int cy)
+{
+    MazeMesh mesh;
+    int ox = cx * CHUNK_BLOCKS;
+    int oy = cy * CHUNK_BLOCKS;
+
+    /** The padding border holds the edge blocks of the neighbours */
+    BitGrid open = chunk.blocks;
+
+    for (int i = -1; i <= CHUNK_BLOCKS; i++)
+    {
+        open.set(i, -1, isOpen(ox + i, oy - 1));
+        open.set(i, CHUNK_BLOCKS, isOpen(ox + i, oy + CHUNK_BLOCKS));
+        open.set(-1, i, isOpen(ox - 1, oy + i));
+        open.set(CHUNK_BLOCKS, i, isOpen(ox + CHUNK_BLOCKS, oy + i));
+    }
+
+    meshMaze(open, mesh, ox, oy);
+
+    std::vector<unsigned short> indices = mesh.shortIndices();
+
+    chunk.vao = createVao(&mesh.vertices, &mesh.normals, &mesh.texcoords
+                          , indices.data(), indices.size(), GL_UNSIGNED_SHORT);
+    chunk.count = static_cast<GLsizei> (indices.size());
+    chunk.bytes = mesh.vertices.size() * (2 * sizeof(QVector3D) + sizeof(QVector2D))
+            + indices.size() * sizeof(unsigned short);
+    chunk.lru = _lru.insert(_lru.begin(), chunkKey(cx, cy));
+    _gpuBytes += chunk.bytes;
+}
+
+void EndlessMaze::touch(Chunk &chunk)
+{
+    chunk.lastFrame = _frame;
+    _lru.splice(_lru.begin(), _lru, chunk.lru);
+}
+
+void EndlessMaze::evict()
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    /** Chunks near an observer in the current frame are never evicted */
+    while (_gpuBytes > _gpuBudget && !_lru.empty())
+    {
+        Chunk &chunk = _chunks.at(_lru.back());
+
+        if (chunk.lastFrame == _frame)
+            break;
+
+        f->glDeleteVertexArrays(1, &chunk.vao);
+        _gpuBytes -= chunk.bytes;
+        chunk.vao = 0;
+        chunk.count = 0;
+        chunk.bytes = 0;
+        _lru.pop_back();
+    }
+}
+
+/**
+ * @brief EndlessMaze::prune drops the block data of chunks that are not on
+ * the GPU once there are more than MAX_CPU_CHUNKS; it is cheap to
+ * regenerate. Chunks next to the view radius around an observer are kept,
+ * since meshing reads their border blocks.
+ */
+void EndlessMaze::prune()
+{
+    if (_chunks.size() < MAX_CPU_CHUNKS)
+        return;
+
+    for (auto c = _chunks.begin(); c != _chunks.end(); )
+    {
+        bool nearby = false;
+
+        for (uint64_t centre : _centres)
+            nearby = nearby || std::max(std::abs(chunkX(c->first) - chunkX(centre))
+                                        , std::abs(chunkY(c->first) - chunkY(centre))) <= _radius + 1;
+
+        c = c->second.vao == 0 && !nearby ? _chunks.erase(c) : std::next(c);
+    }
+}
+
+/**
+ * @brief EndlessMaze::stream makes the chunks around every observer
+ * resident, nearest rings of all observers first, uploading at most
+ * CHUNK_UPLOADS_PER_FRAME new ones
+ */
+void EndlessMaze::stream()
+{
+    int uploads = 0;
+
+    for (int d = 0; d <= _radius; d++)
+        for (uint64_t centre : _centres)
+        {
+            int cx = chunkX(centre);
+            int cy = chunkY(centre);
+
+            for (int y = cy - d; y <= cy + d; y++)
+                for (int x = cx - d; x <= cx + d; x++)
+                {
+                    if (std::max(std::abs(x - cx), std::abs(y - cy)) != d)
+                        continue;
+
+                    Chunk &chunk = chunkAt(x, y);
+
+                    if (chunk.vao == 0)
+                    {
+                        if (uploads == CHUNK_UPLOADS_PER_FRAME)
+                            continue;
+
+                        upload(chunk, x, y);
+                        uploads++;
+                    }
+
+                    touch(chunk);
+                }
+        }
+}
+
+/**
+ * @brief EndlessMaze::beginFrame streams the chunks around the world
+ * positions eyes of all observers; call it once per frame, before the
+ * windows are rendered
+ */
+void EndlessMaze::beginFrame(const std::vector<QVector3D> &eyes)
+{
+    QMatrix4x4 toMaze = getModelMatrix().inverted();
+
+    _frame++;
+    _centres.clear();
+
+    for (QVector3D eye : eyes)
+    {
+        QVector3D p = toMaze * eye;
+        uint64_t key = chunkKey(chunkOf(p.x()), chunkOf(p.z()));
+
+        if (std::find(_centres.begin(), _centres.end(), key) == _centres.end())
+            _centres.push_back(key);
+    }
+
+    prune();
+    stream();
+    evict();
+}
+
+void EndlessMaze::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
+{
+    QMatrix4x4 model = getModelMatrix();
+    QVector3D eye = model.inverted() * (vMatrix.inverted() * QVector3D(0.f, 0.f, 0.f));
+    int cx = chunkOf(eye.x());
+    int cy = chunkOf(eye.z());
+
+    /** Only draws what beginFrame() made resident */
+
+    for (int y = cy - _radius; y <= cy + _radius; y++)
+        for (int x = cx - _radius; x <= cx + _radius; x++)
+        {
+            auto it = _chunks.find(chunkKey(x, y));
+
+            if (it == _chunks.end() || it->second.vao == 0)
+                continue;
+
+            BoundingBox bounds = BoundingBox(
+                        QVector3D(x * CHUNK_BLOCKS - 0.5f, -0.5f, y * CHUNK_BLOCKS - 0.5f)
+                        , QVector3D((x + 1) * CHUNK_BLOCKS - 0.5f, 0.5f, (y + 1) * CHUNK_BLOCKS - 0.5f));
+
+            queue.push(DrawItem(&getShader(), &getMaterial(), it->second.vao
+                                , GL_TRIANGLES, it->second.count, GL_UNSIGNED_SHORT, model)
+                       , transformBox(model, bounds));
+        }
+}
@@ -0,0 +1,68 @@
+#ifndef ENDLESSMAZE_H
+#define ENDLESSMAZE_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <QVector3D>
+#include <drawable.h>
+#include <aabb.h>
+#include <aabbstore.h>
+#include <mazechunk.h>
+
+/**
+ * @brief The EndlessMaze class is a maze without borders, streamed in chunks
+ * around the viewer
+ *
+ * Chunk blocks are generated on demand by generateChunk() and are identical
+ * on every process for the same seed. beginFrame(), called once per frame
+ * with the positions of all observers, meshes and uploads the chunks within
+ * the view radius of any of them lazily, a few per frame; chunks not near an
+ * observer for a while are evicted least recently used first once the
+ * uploaded geometry exceeds the GPU budget. Every window then draws the
+ * resident chunks around its view.
+ */
+class EndlessMaze : public Drawable
+{
+public:
+    EndlessMaze(uint64_t seed = 0, int radius = 3, size_t gpuBudget = 64 * 1024 * 1024);
+
+    void beginFrame(const std::vector<QVector3D> &eyes);
+    bool isOpen(int x, int y);
+    QVector3D getRandomPos() const;
+    QVector3D collision(QVector3D position, QVector3D movement, BoundingBox observerBox);
+    void setGpuBudget(size_t bytes);
+    size_t getGpuBytes() const;
+
+private:
+    struct Chunk {
+        BitGrid blocks;
+        GLuint vao = 0;
+        GLsizei count = 0;
+        size_t bytes = 0;
+        unsigned int lastFrame = 0;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix) override;
+    Chunk &chunkAt(int cx, int cy);
+    void prune();
+    void stream();
+    void upload(Chunk &chunk, int cx, int cy);
+    void evict();
+    void touch(Chunk &chunk);
+
+    uint64_t _seed;
+    int _radius;
+    size_t _gpuBudget;
+    size_t _gpuBytes = 0;
+    unsigned int _frame = 0;
+    std::unordered_map<uint64_t, Chunk> _chunks;
+    std::list<uint64_t> _lru;   // uploaded chunks, most recently used first
+    std::vector<uint64_t> _centres; // chunks of the observers this frame
+    AabbStore _store;
+    std::vector<unsigned int> _blockers;
+};
+
+#endif // ENDLESSMAZE_H
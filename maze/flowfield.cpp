@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "flowfield.h"
+
+namespace {
+
+/** Offsets of the Direction values, NONE first */
+const int DX[] = {0, -1, 1, 0, 0};
+const int DY[] = {0, 0, 0, -1, 1};
+
+/** Direction pointing back, from the neighbour to the block */
+const uint8_t OPPOSITE[] = {0, 2, 1, 4, 3};
+
+}
+
+const uint32_t FlowField::UNREACHABLE;
+
+bool FlowField::inside(int x, int y) const
+{
+    return x >= 0 && y >= 0 && x < _width && y < _height;
+}
+
+/**
+ * @brief FlowField::build computes the field for the open blocks of open
+ * towards the blocks containing the target positions
+ */
+void FlowField::build(const BitGrid &open, const std::vector<QVector3D> &targets)
+{
+    std::vector<size_t> queue;
+
+    _width = open.width();
+    _height = open.height();
+    _distance.assign(static_cast<size_t> (_width) * static_cast<size_t> (_height), UNREACHABLE);
+    _direction.assign(_distance.size(), NONE);
+    _target.assign(_distance.size(), false);
+
+    for (QVector3D t : targets)
+    {
+        int x = static_cast<int> (std::floor(t.x() + 0.5f));
+        int y = static_cast<int> (std::floor(t.z() + 0.5f));
+
+        /** Targets on closed blocks come into effect once they open */
+        if (!inside(x, y) || _target[index(x, y)])
+            continue;
+
+        _target[index(x, y)] = true;
+
+        if (!open.get(x, y))
+            continue;
+
+        _distance[index(x, y)] = 0;
+        queue.push_back(index(x, y));
+    }
+
+    relax(open, queue);
+}
+
+/**
+ * @brief FlowField::relax lowers the distances of the neighbours of the
+ * queued blocks as far as possible; the queued blocks must be ordered by
+ * distance
+ *
+ * With unit steps the queue stays ordered when appending, so this is a plain
+ * breadth-first search.
+ */
+void FlowField::relax(const BitGrid &open, std::vector<size_t> &queue)
+{
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        size_t i = queue[head];
+        int x = static_cast<int> (i % static_cast<size_t> (_width));
+        int y = static_cast<int> (i / static_cast<size_t> (_width));
+        uint32_t d = _distance[i] + 1;
+        unsigned int neighbours = open.neighbours(x, y);
+
+        for (uint8_t dir = WEST; dir <= SOUTH; dir++)
+        {
+            if (!(neighbours & (1u << (dir - 1))))
+                continue;
+
+            size_t n = index(x + DX[dir], y + DY[dir]);
+
+            if (_distance[n] <= d)
+                continue;
+
+            _distance[n] = d;
+            _direction[n] = OPPOSITE[dir];
+            queue.push_back(n);
+        }
+    }
+}
+
+/**
+ * @brief FlowField::invalidate clears the distance of (x, y) and of every
+ * block whose path leads through it, collecting them in region
+ */
+void FlowField::invalidate(int x, int y, std::vector<size_t> &region)
+{
+    size_t first = region.size();
+
+    region.push_back(index(x, y));
+
+    for (size_t head = first; head < region.size(); head++)
+    {
+        size_t i = region[head];
+        int bx = static_cast<int> (i % static_cast<size_t> (_width));
+        int by = static_cast<int> (i / static_cast<size_t> (_width));
+
+        _distance[i] = UNREACHABLE;
+        _direction[i] = NONE;
+
+        for (uint8_t dir = WEST; dir <= SOUTH; dir++)
+        {
+            int nx = bx + DX[dir];
+            int ny = by + DY[dir];
+
+            if (inside(nx, ny) && _direction[index(nx, ny)] == OPPOSITE[dir]
+                    && _distance[index(nx, ny)] != UNREACHABLE)
+                region.push_back(index(nx, ny));
+        }
+    }
+}
+
+/**
+ * @brief FlowField::update repairs the field after block (x, y) of open was
+ * opened or closed
+ *
+ * An opened block takes the best distance of its neighbours and passes the
+ * improvement on. A closed block invalidates the blocks that were routed
+ * through it; those are then filled in again, nearest first, from the valid
+ * blocks bordering them.
+ */
+void FlowField::update(const BitGrid &open, int x, int y)
+{
+    if (!inside(x, y))
+        return;
+
+    size_t i = index(x, y);
+    std::vector<size_t> queue;
+
+    if (open.get(x, y))
+    {
+        if (_target[i])
+            _distance[i] = 0;
+
+        for (uint8_t dir = WEST; dir <= SOUTH && !_target[i]; dir++)
+        {
+            int nx = x + DX[dir];
+            int ny = y + DY[dir];
+
+            if (open.at(nx, ny) && _distance[index(nx, ny)] != UNREACHABLE
+                    && _distance[index(nx, ny)] + 1 < _distance[i])
+            {
+                _distance[i] = _distance[index(nx, ny)] + 1;
+                _direction[i] = dir;
+            }
+        }
+
+        if (_distance[i] != UNREACHABLE)
+        {
+            queue.push_back(i);
+            relax(open, queue);
+        }
+
+        return;
+    }
+
+    std::vector<size_t> region;
+
+    invalidate(x, y, region);
+
+    /** Seeds get different distances, so order them before relaxing */
+    typedef std::pair<uint32_t, size_t> Seed;
+    std::priority_queue<Seed, std::vector<Seed>, std::greater<Seed>> seeds;
+
+    for (size_t r : region)
+    {
+        int bx = static_cast<int> (r % static_cast<size_t> (_width));
+        int by = static_cast<int> (r / static_cast<size_t> (_width));
+
+        if (!open.get(bx, by))
+            continue;
+
+        if (_target[r])
+        {
+            _distance[r] = 0;
+            seeds.push(Seed(0, r));
+            continue;
+        }
+
+        for (uint8_t dir = WEST; dir <= SOUTH; dir++)
+        {
+            int nx = bx + DX[dir];
+            int ny = by + DY[dir];
+
+            if (!open.at(nx, ny) || _distance[index(nx, ny)] == UNREACHABLE
+                    || _distance[index(nx, ny)] + 1 >= _distance[r])
+                continue;
+
+            _distance[r] = _distance[index(nx, ny)] + 1;
+            _direction[r] = dir;
+        }
+
+        if (_distance[r] != UNREACHABLE)
+            seeds.push(Seed(_distance[r], r));
+    }
+
+    /** Dijkstra over the invalidated region, one block at a time */
+    while (!seeds.empty())
+    {
+        Seed s = seeds.top();
+
+        seeds.pop();
+
+        if (s.first != _distance[s.second])
+            continue;
+
+        int bx = static_cast<int> (s.second % static_cast<size_t> (_width));
+        int by = static_cast<int> (s.second / static_cast<size_t> (_width));
+        unsigned int neighbours = open.neighbours(bx, by);
+
+        for (uint8_t dir = WEST; dir <= SOUTH; dir++)
+        {
+            if (!(neighbours & (1u << (dir - 1))))
+                continue;
+
+            size_t n = index(bx + DX[dir], by + DY[dir]);
+
+            if (_distance[n] <= s.first + 1)
+                continue;
+
+            _distance[n] = s.first + 1;
+            _direction[n] = OPPOSITE[dir];
+            seeds.push(Seed(_distance[n], n));
+        }
+    }
+}
+
+uint32_t FlowField::distance(int x, int y) const
+{
+    return inside(x, y) ? _distance[index(x, y)] : UNREACHABLE;
+}
+
+FlowField::Direction FlowField::direction(int x, int y) const
+{
+    return inside(x, y) ? static_cast<Direction> (_direction[index(x, y)]) : NONE;
+}
+
+/**
+ * @brief FlowField::flow returns the unit vector from position towards the
+ * centre of the next block on the way to the nearest target, or a null
+ * vector on a target or unreachable block
+ *
+ * Heading for block centres keeps walkers from cutting wall corners.
+ */
+QVector3D FlowField::flow(QVector3D position) const
+{
+    int x = static_cast<int> (std::floor(position.x() + 0.5f));
+    int y = static_cast<int> (std::floor(position.z() + 0.5f));
+    Direction dir = direction(x, y);
+
+    if (dir == NONE)
+        return QVector3D();
+
+    QVector3D next(x + DX[dir], position.y(), y + DY[dir]);
+
+    return (next - position).normalized();
+}
@@ -0,0 +1,55 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <cstdint>
+#include <vector>
+#include <QVector3D>
+#include <bitgrid.h>
+
+/**
+ * @brief The FlowField class holds the walking distance from every open
+ * block of a maze grid to the nearest target block, and the direction to go
+ * from each block to get there
+ *
+ * Distances are found by a breadth-first search from all targets at once.
+ * Each block stores the neighbour it was reached from, so an agent steers by
+ * a single lookup. When blocks of the grid open or close, update() repairs
+ * only the blocks whose distance changes.
+ */
+class FlowField
+{
+public:
+    static const uint32_t UNREACHABLE = UINT32_MAX;
+
+    /** Values of direction(): the neighbour to walk to */
+    enum Direction {
+        NONE,   // target or unreachable block
+        WEST,
+        EAST,
+        NORTH,
+        SOUTH
+    };
+
+    void build(const BitGrid &open, const std::vector<QVector3D> &targets);
+    void update(const BitGrid &open, int x, int y);
+    uint32_t distance(int x, int y) const;
+    Direction direction(int x, int y) const;
+    QVector3D flow(QVector3D position) const;
+
+private:
+    size_t index(int x, int y) const
+    {
+        return static_cast<size_t> (y) * static_cast<size_t> (_width) + static_cast<size_t> (x);
+    }
+    bool inside(int x, int y) const;
+    void relax(const BitGrid &open, std::vector<size_t> &queue);
+    void invalidate(int x, int y, std::vector<size_t> &region);
+
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint32_t> _distance;
+    std::vector<uint8_t> _direction;
+    std::vector<bool> _target;
+};
+
+#endif // FLOWFIELD_H
@@ -0,0 +1,69 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <algorithm>
+#include <QMatrix4x4>
+#include <QVector4D>
+#include <boundingbox.h>
+
+/**
+ * @brief The Frustum struct holds the six clip planes of a view-projection
+ * matrix, normals pointing inwards, for culling bounding boxes
+ */
+struct Frustum {
+    QVector4D planes[6];
+
+    explicit Frustum(const QMatrix4x4 &viewProjection)
+    {
+        QVector4D w = viewProjection.row(3);
+
+        for (int i = 0; i < 3; i++)
+        {
+            planes[2 * i] = w + viewProjection.row(i);
+            planes[2 * i + 1] = w - viewProjection.row(i);
+        }
+    }
+
+    /** False only if box lies entirely outside of one plane */
+    bool intersects(const BoundingBox &box) const
+    {
+        for (const QVector4D &p : planes)
+        {
+            QVector3D corner = QVector3D(p.x() >= 0.f ? box.b.x() : box.a.x()
+                                         , p.y() >= 0.f ? box.b.y() : box.a.y()
+                                         , p.z() >= 0.f ? box.b.z() : box.a.z());
+
+            if (QVector4D::dotProduct(p, QVector4D(corner, 1.f)) < 0.f)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief transformBox returns the axis aligned bounds of box transformed by m
+ */
+inline BoundingBox transformBox(const QMatrix4x4 &m, const BoundingBox &box)
+{
+    QVector3D first = m * box.a;
+    BoundingBox result = BoundingBox(first, first);
+
+    for (int i = 1; i < 8; i++)
+    {
+        QVector3D p = m * QVector3D(i & 1 ? box.b.x() : box.a.x()
+                                    , i & 2 ? box.b.y() : box.a.y()
+                                    , i & 4 ? box.b.z() : box.a.z());
+
+        result.a = QVector3D(std::min(result.a.x(), p.x())
+                             , std::min(result.a.y(), p.y())
+                             , std::min(result.a.z(), p.z()));
+        result.b = QVector3D(std::max(result.b.x(), p.x())
+                             , std::max(result.b.y(), p.y())
+                             , std::max(result.b.z(), p.z()));
+    }
+
+    return result;
+}
+
+#endif // FRUSTUM_H
@@ -26,15 +26,26 @@
 #endif
 
 #define MAZE 1
+#define ENDLESS_MAZE 0
+#define CROWD_AGENTS 0
 #define CUSTOM_NAV true
 #define WALK_SPEED .001f
 #define SIZE 0.1f
 #define LIFT_TIME 3 * 1000.f
+#define SIM_STEP_MILLIS (1000.f / 60.f)
+#define MAX_SIM_STEPS 5
+#define BUTTON_TRIGGER 1
+#define GOAL_TRIGGER 2
 
 #ifdef _WIN32
 #include <Windows.h>
 #endif
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
 #include <QGuiApplication>
 #include <QKeyEvent>
 #include <QImage>
@@ -46,31 +57,31 @@
 #include <qvr/device.hpp>
 
 #include "main.hpp"
+#include "shadercache.h"
+#include "texturecache.h"
 
 #include "geometries.hpp"
 
 static QString BUTTON = QString("Button");
 static QString GOAL = QString("Goal");
 static bool isGLES = false; // is this OpenGL ES or plain OpenGL?
+static bool allowMultiview = true; // single pass stereo, unless --no-multiview
 
 const float ANIMATION_SPEED = 0.1f;
 
-Main::Main() :
+Main::Main(quint64 mazeSeed) :
   _wantExit(false)
+  , _mazeSeed(mazeSeed)
   , _objectRotationAngle(0.0f)
 {
     _timer.start();
 }
 
-unsigned int Main::setupTex(const QString& filename)
+unsigned int Main::setupTex(const QString& filename, QRgb placeholder)
 {
-    QImage img;
-    img.load(filename);
-    if (isGLES)
-        img = img.scaledToWidth(img.width() / 2, Qt::SmoothTransformation);
-    img = img.mirrored(false, true);
-    img = img.convertToFormat(QImage::Format_RGBA8888);
-    return setupTex(img);
+    std::shared_ptr<Texture> texture = TextureCache::texture(filename, isGLES, placeholder);
+    _textures.push_back(texture);
+    return texture->name();
 }
 
 unsigned int Main::setupTex(const QImage& img)
@@ -175,14 +186,38 @@ void Main::renderVao(const QMatrix4x4& projectionMatrix,
     glDrawElements(GL_TRIANGLES, indices, GL_UNSIGNED_SHORT, nullptr);
 }
 
+void Main::serializeStaticData(QDataStream& ds) const
+{
+    ds << _mazeSeed;
+}
+
+void Main::deserializeStaticData(QDataStream& ds)
+{
+    ds >> _mazeSeed;
+}
+
 void Main::serializeDynamicData(QDataStream& ds) const
 {
     ds << _objectRotationAngle;
+    ds << static_cast<quint32> (_renderOffsets.size());
+    for (QVector3D offset : _renderOffsets)
+        ds << offset;
+    if (_crowd)
+        _crowd->serialize(ds);
 }
 
 void Main::deserializeDynamicData(QDataStream& ds)
 {
+    quint32 obstacles;
+
     ds >> _objectRotationAngle;
+    ds >> obstacles;
+    _renderOffsets.resize(obstacles);
+    for (QVector3D &offset : _renderOffsets)
+        ds >> offset;
+    placeObstacles(_renderOffsets);
+    if (_crowd)
+        _crowd->deserialize(ds);
 }
 
 void Main::update(const QList<QVRObserver*>& observerList)
@@ -207,7 +242,12 @@ void Main::update(const QList<QVRObserver*>& observerList)
     /** Initial observer placement and maze position adjustment */
     if (!_mazeInited)
     {
+#if(ENDLESS_MAZE)
+		_position = _endless->getRandomPos();
+#else
 		_position = _root->getRandomPos();
+#endif
+        _prevPosition = _position;
         _mazeInited = true;
     }
 
@@ -218,22 +258,92 @@ void Main::update(const QList<QVRObserver*>& observerList)
 		observer->setTracking(_position, _orientation);
 	}
 
-	QVector3D position = _root->collision(
-		_position
-		, _orientation.rotatedVector(QVector3D(WALK_SPEED * _moveXAxis * millis, 0, WALK_SPEED * _moveZAxis * millis))
-		, _observerBox->getBox()
-	);
+    /** The simulation runs in fixed steps, independent of the frame rate.
+     *  After a stall it catches up at most MAX_SIM_STEPS steps and drops
+     *  the rest instead of spiraling. */
+    _simAccumulator += millis;
 
-	_position = QVector3D(position.x(), 0, position.z());
-	observer->setTracking(_position, _orientation);
-	
-	QMatrix4x4 translation;
-	translation.translate(observer->trackingPosition());
+    for (int steps = 0; _simAccumulator >= SIM_STEP_MILLIS; steps++)
+    {
+        if (steps == MAX_SIM_STEPS)
+        {
+            _simAccumulator = std::fmod(_simAccumulator, SIM_STEP_MILLIS);
+            break;
+        }
 
-	_observerBox->setGlobalTransform(translation);
-	
-     for (std::shared_ptr<Aabb> obstacle : _obstacles)
-         obstacle->update(QMatrix4x4(), millis);
+        simulate(SIM_STEP_MILLIS);
+        _simAccumulator -= SIM_STEP_MILLIS;
+    }
+
+    /** Render between the last two steps */
+    float alpha = _simAccumulator / SIM_STEP_MILLIS;
+    QVector3D position = _prevPosition + (_position - _prevPosition) * alpha;
+
+    observer->setTracking(position, _orientation);
+
+    QMatrix4x4 translation;
+    translation.translate(position);
+    _observerBox->setGlobalTransform(translation);
+
+    for (size_t i = 0; i < _obstacleOffsets.size(); i++)
+        _renderOffsets[i] = _prevObstacleOffsets[i] + (_obstacleOffsets[i] - _prevObstacleOffsets[i]) * alpha;
+
+    placeObstacles(_renderOffsets);
+}
+
+/**
+ * @brief Main::simulate advances observer, obstacles, walkers and triggers
+ * by one fixed step
+ */
+void Main::simulate(float stepMillis)
+{
+    _prevPosition = _position;
+    _prevObstacleOffsets = _obstacleOffsets;
+
+    for (QVector3D &offset : _obstacleOffsets)
+        offset += _obstacleVelocity;
+
+    placeObstacles(_obstacleOffsets);
+
+    QMatrix4x4 translation;
+    translation.translate(_position);
+    _observerBox->setGlobalTransform(translation);
+
+    QVector3D movement = _orientation.rotatedVector(
+                QVector3D(WALK_SPEED * _moveXAxis * stepMillis, 0, WALK_SPEED * _moveZAxis * stepMillis));
+
+#if(ENDLESS_MAZE)
+    QVector3D position = _endless->collision(_position, movement, _observerBox->getBox());
+#else
+    QVector3D position = _root->collision(_position, movement, _observerBox->getBox());
+
+    /** The whole way of the step counts, so fast movement cannot skip over
+     *  buttons and goals */
+    _root->getTriggers().moveActor(_observerActor, _observerBox->getBox(), position - _position);
+#endif
+
+    _position = QVector3D(position.x(), 0, position.z());
+
+    if (_crowd)
+        _crowd->step(stepMillis);
+
+#if(!ENDLESS_MAZE)
+    _root->getTriggers().tick();
+#endif
+}
+
+/**
+ * @brief Main::placeObstacles moves every obstacle by its offset from where
+ * it was created
+ */
+void Main::placeObstacles(const std::vector<QVector3D> &offsets)
+{
+    for (size_t i = 0; i < _obstacles.size() && i < offsets.size(); i++)
+    {
+        QMatrix4x4 translation;
+        translation.translate(offsets[i]);
+        _obstacles[i]->setGlobalTransform(translation);
+    }
 }
 
 bool Main::wantExit()
@@ -241,6 +351,36 @@ bool Main::wantExit()
     return _wantExit;
 }
 
+void Main::preRenderProcess(QVRProcess* /* p */)
+{
+    // Replace texture placeholders with images decoded in the background,
+    // and drop unused textures over the budget
+    TextureLoader::instance()->upload();
+    TextureCache::evict();
+
+    // Hand the debug primitives of the last frame and the changed collider
+    // boxes to all windows
+    DebugDraw::instance()->endFrame();
+    DebugBoxRenderer::instance()->endFrame();
+
+#if(ENDLESS_MAZE)
+    // Stream the chunks around every observer, once for all windows
+    std::vector<QVector3D> eyes;
+
+    for (int i = 0; i < QVRManager::observerCount(); i++) {
+        const QVRObserver& observer = QVRManager::observer(i);
+        eyes.push_back(observer.navigationMatrix() * observer.trackingPosition());
+    }
+    _endless->beginFrame(eyes);
+#endif
+}
+
+void Main::exitProcess(QVRProcess* /* p */)
+{
+    // Stop decoding while the application still exists
+    TextureLoader::instance()->stop();
+}
+
 // Helper function: read a complete file into a QString (without error checking)
 static QString readFile(const char* fileName)
 {
@@ -256,17 +396,6 @@ bool Main::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // FBO
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
      //// Device model data
      //for (int i = 0; i < QVRManager::deviceModelVertexDataCount(); i++) {
      //    _devModelVaos.append(setupVao(
@@ -282,12 +411,21 @@ bool Main::initProcess(QVRProcess* /* p */)
      //    _devModelTextures.append(setupTex(QVRManager::deviceModelTexture(i)));
      //}
 
-     std::shared_ptr<Maze> maze = std::make_shared<Maze>(32, 32);
+    /** Programs get their multiview variants only if stereo can use them */
+    Drawable::setMultiview(allowMultiview && MultiviewTarget::supported());
+
+#if(ENDLESS_MAZE)
+    _endless = std::make_shared<EndlessMaze>(_mazeSeed);
+#else
+     std::shared_ptr<Maze> maze = std::make_shared<Maze>(32, 32, _mazeSeed);
+     std::vector<QVector3D> spawns = maze->getSpreadPositions(3 * 10);
+     std::vector<std::shared_ptr<Aabb>> buttons;
+     std::vector<QVector3D> goals;
 
 
      for (unsigned short i = 0; i < 10; i++)
      {
-         QVector3D pos = maze->getRandomPos();
+         QVector3D pos = spawns[3 * i];
          std::shared_ptr<Aabb> obstacle = std::make_shared<Aabb>(
                      pos - QVector3D(0.2f, .8, 0.2f)
                      , pos + QVector3D(0.2f, 0.2f, 0.5f)
@@ -296,7 +434,7 @@ bool Main::initProcess(QVRProcess* /* p */)
          maze->addObstacle(obstacle);
          _obstacles.push_back(obstacle);
 
-         pos = maze->getRandomPos();
+         pos = spawns[3 * i + 1];
          std::shared_ptr<Aabb> button = std::make_shared<Aabb>(
                      pos - QVector3D(0.2f, 0.5, 0.2f)
                      , pos + QVector3D(0.2f, 0.3, 0.2f)
@@ -304,15 +442,11 @@ bool Main::initProcess(QVRProcess* /* p */)
                      , QVector3D(0.5, 0.5, 1)
                      , BUTTON);
 
-         maze->addObstacle(button);
-
-         QObject::connect(button.get()
-                          , &Aabb::collided
-                          , this
-                          , &Main::buttonHit
-                          );
+         _triggerBoxes.push_back(button);
+         maze->addTrigger(button, BUTTON_TRIGGER);
+         buttons.push_back(button);
 
-         pos = maze->getRandomPos();
+         pos = spawns[3 * i + 2];
          std::shared_ptr<Aabb> goal = std::make_shared<Aabb>(
                      pos - QVector3D(0.2f, 0.5, 0.2f)
                      , pos + QVector3D(0.2f, 0.2, 0.2f)
@@ -320,29 +454,41 @@ bool Main::initProcess(QVRProcess* /* p */)
                      , QVector3D(0, 1, 0)
                      , GOAL);
 
-         maze->addObstacle(goal);
-
-         QObject::connect(goal.get()
-                          , &Aabb::collided
-                          , this
-                          , &Main::reachedGoal
-                          );
+         _triggerBoxes.push_back(goal);
+         maze->addTrigger(goal, GOAL_TRIGGER);
+         goals.push_back(pos);
      }
 
+#if(CROWD_AGENTS)
+    std::vector<QVector3D> buttonPositions;
+
+    for (std::shared_ptr<Aabb> button : buttons)
+        buttonPositions.push_back(0.5f * (button->getBox().a + button->getBox().b));
+
+    _crowd = std::make_shared<Crowd>(maze->getGrid(), maze->flowTo(buttonPositions), maze->flowTo(goals));
+    _crowd->spawn(maze->getSpreadPositions(CROWD_AGENTS));
+
+    _crowd->setTriggers(maze->getTriggers());
+
+    maze->addChild(_crowd);
+#endif
     _root = maze;
+    _observerActor = maze->getTriggers().addActor();
+    maze->getTriggers().addListener([this](const std::vector<TriggerEvent> &events)
+    {
+        triggered(events);
+    });
+#endif
+    _triggerOccupants.assign(_triggerBoxes.size(), 0);
+    _obstacleOffsets.assign(_obstacles.size(), QVector3D());
+    _prevObstacleOffsets = _obstacleOffsets;
+    _renderOffsets = _obstacleOffsets;
     _observerBox = std::make_shared<Aabb> (
                 QVector3D(-SIZE, -SIZE, -SIZE)
                 , QVector3D(SIZE, SIZE, SIZE)
                 , true
                 , QVector3D(1, 0.8f, 0)
                 );
-    _line = std::make_shared<Line> ("ray"
-                                    , std::vector<QVector3D>({QVector3D(), QVector3D()})
-                                    , QVector3D(1, 1, 0)
-                                    );
-	
-    maze->addChild(_line);
-	
 
    return true;
 }
@@ -350,18 +496,50 @@ bool Main::initProcess(QVRProcess* /* p */)
 void Main::render(QVRWindow* /* w */,
         const QVRRenderContext& context, const unsigned int* textures)
 {
+    /** Flatten the scene once, sorted by GL state, and submit it per view;
+     *  submit() culls the maze chunks against the frustum of each view */
+    _queue.clear();
+    DebugBoxRenderer::instance()->collect(_queue, context.viewMatrixPure(0));
+    DebugDraw::instance()->collect(_queue, context.viewMatrixPure(0));
+#if(ENDLESS_MAZE)
+    _endless->collect(_queue, context.viewMatrixPure(0));
+#else
+    _root->collect(_queue, context.viewMatrixPure(0));
+#endif
+    _queue.prepare();
+
+    /** The mouse ray, drawn from the next frame on */
+    QRect viewport = QRect(QPoint(0, 0), context.textureSize(0));
+    QVector3D line_p0 = QVector3D(viewport.width() / 2,  viewport.height() / 2, 0);
+    QVector3D line_p1 = QVector3D(_mousePos.x(), _mousePos.y(), 1);
+
+    line_p0.unproject(context.viewMatrixPure(0), context.frustum(0).toMatrix4x4(), viewport);
+    line_p1.unproject(context.viewMatrixPure(0), context.frustum(0).toMatrix4x4(), viewport);
+    DebugDraw::instance()->line(line_p0, line_p1, QVector3D(1, 1, 0));
+
+    /** Stereo in one pass: every item is drawn once into both layers of the
+     *  multiview target, which are then copied to the view textures */
+    if (Drawable::getMultiview() && context.viewCount() == MAX_VIEWS
+            && context.textureSize(0) == context.textureSize(1)
+            && context.textureFormat(0) == context.textureFormat(1)) {
+        QMatrix4x4 viewMatrices[MAX_VIEWS];
+        QMatrix4x4 projectionMatrices[MAX_VIEWS];
+
+        for (int view = 0; view < MAX_VIEWS; view++) {
+            viewMatrices[view] = context.viewMatrixPure(view);
+            projectionMatrices[view] = context.frustum(view).toMatrix4x4();
+        }
+
+        _multiview.bind(viewport.width(), viewport.height(), context.textureFormat(0));
+        glEnable(GL_DEPTH_TEST);
+        _queue.submit(viewMatrices, projectionMatrices, MAX_VIEWS);
+        _multiview.resolve(textures);
+        return;
+    }
+
     for (int view = 0; view < context.viewCount(); view++) {
-        // Get view dimensions
-        int width = context.textureSize(view).width();
-        int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height,
-                0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
-        // Set up view
-        glViewport(0, 0, width, height);
+        // Set up framebuffer object and view
+        context.bindView(view);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         QMatrix4x4 projectionMatrix = context.frustum(view).toMatrix4x4();
         QMatrix4x4 viewMatrix = context.viewMatrixPure(view);
@@ -369,20 +547,7 @@ void Main::render(QVRWindow* /* w */,
         glEnable(GL_DEPTH_TEST);
         // Render scene
 
-        _observerBox->render(viewMatrix, projectionMatrix);
-        _root->render(viewMatrix, projectionMatrix);
-
-        QRect viewport = QRect(0, 0, width, height);
-        QVector3D line_p0 = QVector3D(width / 2,  height / 2, 0);
-        QVector3D line_p1 = QVector3D(_mousePos.x(), _mousePos.y(), 1);
-
-        line_p0.unproject(viewMatrix, projectionMatrix, viewport);
-        line_p1.unproject(viewMatrix, projectionMatrix, viewport);
-
-        _line->setLine(std::vector<QVector3D>({
-                                                  line_p0
-                                                  , line_p1
-                                              }));
+        _queue.submit(viewMatrix, projectionMatrix);
 
         // Render device models (optional)
 #if 0
@@ -405,9 +570,8 @@ void Main::render(QVRWindow* /* w */,
             }
         }
 #endif
-        // Invalidate depth attachment (to help OpenGL ES performance)
-        const GLenum fboInvalidations[] = { GL_DEPTH_ATTACHMENT };
-        glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, fboInvalidations);
+        // Resolve and invalidate depth attachment (to help OpenGL ES performance)
+        context.finishView();
     }
 }
 #endif
@@ -477,6 +641,43 @@ void Main::mouseReleaseEvent(const QVRRenderContext &context, QMouseEvent *event
     _moveZAxis = 0;
 }
 
+/**
+ * @brief Main::triggered handles the trigger events of one tick: entering a
+ * button lifts the obstacles, entering a goal ends the game, and trigger
+ * boxes are drawn solid while an actor is inside
+ */
+void Main::triggered(const std::vector<TriggerEvent> &events)
+{
+#if(!ENDLESS_MAZE)
+    TriggerSystem &triggers = _root->getTriggers();
+
+    for (const TriggerEvent &event : events)
+    {
+        if (event.type == TRIGGER_STAY)
+            continue;
+
+        unsigned int &occupants = _triggerOccupants.at(event.trigger);
+
+        occupants = event.type == TRIGGER_ENTER ? occupants + 1 : occupants - 1;
+        _triggerBoxes.at(event.trigger)->setCollided(occupants > 0);
+
+        if (event.type != TRIGGER_ENTER)
+            continue;
+
+        switch (triggers.getTag(event.trigger))
+        {
+        case BUTTON_TRIGGER:
+            buttonHit();
+            break;
+        case GOAL_TRIGGER:
+            if (event.actor == _observerActor)
+                reachedGoal();
+            break;
+        }
+    }
+#endif
+}
+
 void Main::buttonHit()
 {
     if (_obstaclesAnimated)
@@ -508,10 +709,13 @@ void Main::stop()
     _obstaclesAnimated = false;
 }
 
-void Main::animateObstacles(QVector3D offset)
+/**
+ * @brief Main::animateObstacles sets how far all obstacles move per
+ * simulation step
+ */
+void Main::animateObstacles(QVector3D velocity)
 {
-    for (std::shared_ptr<Aabb> obstacle : _obstacles)
-        obstacle->move(offset);
+    _obstacleVelocity = velocity;
 }
 #if(!MAZE)
 bool Main::initProcess(QVRProcess* /* p */)
@@ -525,24 +729,13 @@ bool Main::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // FBO
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
     // Floor
     geom_quad(positions, normals, texcoords, indices);
     _floorVao = setupVao(positions.size() / 3, positions.data(), normals.data(), texcoords.data(),
             indices.size(), indices.data());
     _floorIndices = indices.size();
     _floorMaterial = Material(0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-            setupTex(":floor-diff.jpg"), isGLES ? 0 : setupTex(":floor-norm.jpg"), 0, 10.0f);
+            setupTex(":floor-diff.jpg"), isGLES ? 0 : setupTex(":floor-norm.jpg", TEXTURE_PLACEHOLDER_NORMAL), 0, 10.0f);
 
     // Pillar
     geom_cylinder(positions, normals, texcoords, indices, isGLES ? 20 : 40);
@@ -554,7 +747,7 @@ bool Main::initProcess(QVRProcess* /* p */)
             indices.size(), indices.data());
     _pillarIndices[1] = indices.size();
     _pillarMaterial = Material(0.5f, 0.5f, 0.3f, 0.5f, 0.5f, 100.0f,
-            setupTex(":pillar-diff.jpg"), isGLES ? 0 : setupTex(":pillar-norm.jpg"), isGLES ? 0 : setupTex(":pillar-spec.jpg"));
+            setupTex(":pillar-diff.jpg"), isGLES ? 0 : setupTex(":pillar-norm.jpg", TEXTURE_PLACEHOLDER_NORMAL), isGLES ? 0 : setupTex(":pillar-spec.jpg", TEXTURE_PLACEHOLDER_SPECULAR));
 
     // Object
     geom_cube(positions, normals, texcoords, indices);
@@ -630,20 +823,11 @@ bool Main::initProcess(QVRProcess* /* p */)
 }
 
 void Main::render(QVRWindow* /* w */,
-        const QVRRenderContext& context, const unsigned int* textures)
+        const QVRRenderContext& context, const unsigned int* /* textures */)
 {
     for (int view = 0; view < context.viewCount(); view++) {
-        // Get view dimensions
-        int width = context.textureSize(view).width();
-        int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height,
-                0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
-        // Set up view
-        glViewport(0, 0, width, height);
+        // Set up framebuffer object and view
+        context.bindView(view);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         QMatrix4x4 projectionMatrix = context.frustum(view).toMatrix4x4();
         QMatrix4x4 viewMatrix = context.viewMatrix(view);
@@ -696,20 +880,37 @@ void Main::render(QVRWindow* /* w */,
                         _devModelVaoIndices[vertexDataIndex]);
             }
         }
-        // Invalidate depth attachment (to help OpenGL ES performance)
-        const GLenum fboInvalidations[] = { GL_DEPTH_ATTACHMENT };
-        glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, fboInvalidations);
+        // Resolve and invalidate depth attachment (to help OpenGL ES performance)
+        context.finishView();
     }
 }
 #endif
 
 int main(int argc, char* argv[])
 {
-    srand (time(NULL));
-
     QGuiApplication app(argc, argv);
     QVRManager manager(argc, argv);
 
+    /* The master picks the maze seed; slave processes receive it with the
+     * static data, so every process builds the same maze */
+    quint64 mazeSeed = static_cast<quint64> (time(NULL));
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--maze-seed") == 0 && i < argc - 1)
+            mazeSeed = strtoull(argv[i + 1], nullptr, 10);
+        else if (strncmp(argv[i], "--maze-seed=", 12) == 0)
+            mazeSeed = strtoull(argv[i] + 12, nullptr, 10);
+        else if (strcmp(argv[i], "--shader-cache") == 0 && i < argc - 1)
+            ShaderCache::setDirectory(argv[i + 1]);
+        else if (strncmp(argv[i], "--shader-cache=", 15) == 0)
+            ShaderCache::setDirectory(argv[i] + 15);
+        else if (strcmp(argv[i], "--no-multiview") == 0)
+            allowMultiview = false;
+        else if (strcmp(argv[i], "--texture-budget") == 0 && i < argc - 1)
+            TextureCache::setBudget(strtoll(argv[i + 1], nullptr, 10) * 1024 * 1024);
+        else if (strncmp(argv[i], "--texture-budget=", 17) == 0)
+            TextureCache::setBudget(strtoll(argv[i] + 17, nullptr, 10) * 1024 * 1024);
+    }
+
     isGLES = (QOpenGLContext::openGLModuleType() == QOpenGLContext::LibGLES);
     Drawable::setGLES(isGLES);
 
@@ -725,7 +926,7 @@ int main(int argc, char* argv[])
     QSurfaceFormat::setDefaultFormat(format);
 
 	/* Then start QVR with your app */
-    Main qvrapp;
+    Main qvrapp(mazeSeed);
     if (!manager.init(&qvrapp, CUSTOM_NAV)) {
         qCritical("Cannot initialize QVR manager");
         return 1;
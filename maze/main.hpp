@@ -36,24 +36,26 @@ class QImage;
 #include <aabb.h>
 #include <drawable.h>
 #include <maze.h>
-#include <line.h>
+#include <endlessmaze.h>
+#include <crowd.h>
+#include <debugdraw.h>
+#include <multiviewtarget.h>
 
 class Main : public QObject, public QVRApp, protected QOpenGLExtraFunctions
 {
     Q_OBJECT
 public:
-    Main();
+    Main(quint64 mazeSeed = 0);
 
 private:
     /* Data not directly relevant for rendering */
     bool _wantExit;             // do we want to exit the app?
     QElapsedTimer _timer;       // used for animation purposes
+    quint64 _mazeSeed;          // seed of the maze, the same on all processes
 
     /* Static data for rendering. Here, these are OpenGL resources that are
      * initialized per process, so there is no need to serialize them for
      * multi-process rendering support. */
-    unsigned int _fbo;                // Framebuffer object to render into
-    unsigned int _fboDepthTex;        // Depth attachment for the FBO
     unsigned int _floorVao;           // Vertex array object for the floor
     unsigned int _floorIndices;       // Number of indices to render for the pl.
     Material     _floorMaterial;      // Material of the floor
@@ -66,10 +68,15 @@ private:
     QMatrix4x4   _objectMatrices[5];  // Base transformation matrices of the objs
     QOpenGLShaderProgram _prg;        // GLSL program for rendering
     std::shared_ptr<Maze> _root;      // Scene root
+    std::shared_ptr<EndlessMaze> _endless; // Scene root when ENDLESS_MAZE is set
+    std::shared_ptr<Crowd> _crowd;    // Walkers, when CROWD_AGENTS is set
+    RenderQueue _queue;               // Draw items of the current frame
+    MultiviewTarget _multiview;       // Layered target for single pass stereo
     // Data to render device models
     QVector<unsigned int> _devModelVaos;
     QVector<unsigned int> _devModelVaoIndices;
     QVector<unsigned int> _devModelTextures;
+    std::vector<std::shared_ptr<Texture>> _textures; // Cached textures of the materials
     bool _mazeInited = false;         // Flag indicated whether we have already adjusted the maze position
     QPointF _mousePos = QPointF(0, 0);
     QQuaternion _orientation;
@@ -77,16 +84,24 @@ private:
     float _moveZAxis = 0;               // Move forward/backward
 	float _moveXAxis = 0;				// Move left/right
     std::shared_ptr<Aabb> _observerBox;// Box of the observer
-    std::shared_ptr<Line> _line;
     std::vector<std::shared_ptr<Aabb>> _obstacles;
+    std::vector<std::shared_ptr<Aabb>> _triggerBoxes; // Buttons and goals, by trigger id
+    std::vector<unsigned int> _triggerOccupants;      // Actors inside each trigger
+    unsigned int _observerActor = 0;                  // Trigger actor of the observer
+    float _simAccumulator = 0;          // Elapsed time not simulated yet, in ms
+    QVector3D _prevPosition;            // Observer position at the previous step
+    QVector3D _obstacleVelocity;        // Obstacle movement per step
+    std::vector<QVector3D> _obstacleOffsets;     // Obstacle offsets at the last step
+    std::vector<QVector3D> _prevObstacleOffsets; // Obstacle offsets at the step before
     bool _obstaclesAnimated = false;
 
     /* Dynamic data for rendering. This needs to be serialized for multi-process
      * rendering) */
     float _objectRotationAngle; // animated object rotation
+    std::vector<QVector3D> _renderOffsets; // interpolated obstacle offsets
 
     /* Helper function for texture loading */
-    unsigned int setupTex(const QString& filename);
+    unsigned int setupTex(const QString& filename, QRgb placeholder = TEXTURE_PLACEHOLDER_DIFFUSE);
     unsigned int setupTex(const QImage& img);
     /* Helper function for VAO setup */
     unsigned int setupVao(int vertexCount,
@@ -100,9 +115,14 @@ private:
             unsigned int vao, unsigned int indices);
 
     QVector3D collisionAdjust(QVector3D position, QVector3D movement, float size = 0.5f);
-    void animateObstacles(QVector3D transform);
+    void animateObstacles(QVector3D velocity);
+    void simulate(float stepMillis);
+    void placeObstacles(const std::vector<QVector3D> &offsets);
+    void triggered(const std::vector<TriggerEvent> &events);
 
 public:
+    void serializeStaticData(QDataStream& ds) const override;
+    void deserializeStaticData(QDataStream& ds) override;
     void serializeDynamicData(QDataStream& ds) const override;
     void deserializeDynamicData(QDataStream& ds) override;
 
@@ -111,6 +131,8 @@ public:
     bool wantExit() override;
 
     bool initProcess(QVRProcess* p) override;
+    void exitProcess(QVRProcess* p) override;
+    void preRenderProcess(QVRProcess* p) override;
 
     void render(QVRWindow* w, const QVRRenderContext& c, const unsigned int* textures) override;
 
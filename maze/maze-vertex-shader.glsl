@@ -21,10 +21,41 @@
  * SOFTWARE.
  */
 
-uniform vec3 color;
-layout(location = 0) out vec4 fcolor;
+// Shared by all maze shaders, see uniformblocks.hpp for the C++ side and
+// Drawable::loadShader for the view defines
+$VIEWS
+
+layout(std140) uniform Camera
+{
+    mat4 view_matrices[MAX_VIEWS];
+    mat4 projection_matrices[MAX_VIEWS];
+};
+
+layout(std140) uniform Object
+{
+    mat4 model_matrix;
+    vec4 object_color;
+};
+
+layout(location = 0) in vec4 pos;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texcoord;
+
+smooth out vec3 vnormal; // normal in eye space, not normalized
+smooth out vec3 vlight;  // light vector in eye space, not normalized
+smooth out vec3 vview;   // view vector in eye space, not normalized
+smooth out vec2 vtexcoord;
 
 void main(void)
 {
-    fcolor = vec4(color, 1.0);
+    mat4 view_matrix = view_matrices[VIEW_ID];
+    mat4 projection_matrix = projection_matrices[VIEW_ID];
+    mat4 model_view_matrix = view_matrix * model_matrix;
+    vec4 eye_pos = model_view_matrix * pos;
+    // drawables are only moved and rotated, so no inverse transpose needed
+    vnormal = mat3(model_view_matrix) * normal;
+    vview = -eye_pos.xyz;
+    vlight = -eye_pos.xyz; // light is always at camera pos
+    vtexcoord = texcoord;
+    gl_Position = projection_matrix * eye_pos;
 }
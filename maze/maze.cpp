@@ -1,358 +1,168 @@
 #include <bvec.hpp>
 #include <maze.h>
+#include <frustum.h>
+#include <algorithm>
 #define DRAW_AABB true
-#define MAZE_SCALE 0.1f
+#define MAZE_CHUNK_BLOCKS 16
 
-Maze::Maze(unsigned short width, unsigned short height) :
-    Drawable("Maze"), _width(width), _height(height)
+Maze::Maze(unsigned short width, unsigned short height, uint64_t seed) :
+    Drawable("Maze")
+    , _model(width, height, seed, [this](const BoundingBox &box)
+    {
+        std::shared_ptr<Aabb> wall = std::make_shared<Aabb>(box.a, box.b, DRAW_AABB);
+
+        addChild(wall);
+
+        return wall;
+    })
 {
-    initMaze();
+    std::cout << "initialise maze "
+              << width << "×" << height
+              << " seed " << seed
+              << std::endl;
+
+    generateGeometry();
+    _model.printMaze();
     Drawable::loadShader(
-                ":vertex-shader.glsl"
-                , ":fragment-shader.glsl"
+                ":maze-vertex-shader.glsl"
+                , ":maze-fragment-shader.glsl"
                 );
     Drawable::setMaterial(
                 Material(0.5f, 0.5f, 0.5f, 1.0f, 0.2f, 0.1f,
                          loadTexture(":floor-diff.jpg")
-                         , getGLES() ? 0 : loadTexture(":floor-norm.jpg"), 0, 10.0f
+                         , getGLES() ? 0 : loadTexture(":floor-norm.jpg", TEXTURE_PLACEHOLDER_NORMAL), 0, 10.0f
                          )
                 );
 }
 
-void Maze::initMaze()
-{
-    std::cout << "initialise maze "
-              << _width << "×" << _height
-              << std::endl;
-
-    _maze.assign(static_cast<unsigned short> (_width * _height + 1), false);
-    generate();
-    generateGeometry();
-    printMaze();
-    generateAabb();
-}
-
-void Maze::addRandomLoop()
-{
-    unsigned short xa = static_cast<unsigned short> (rand()) % (_width / 2);
-    unsigned short xb = static_cast<unsigned short> (rand()) % (_width - xa) + xa;
-    unsigned short ya = static_cast<unsigned short> (rand()) % (_height / 2);
-    unsigned short yb = static_cast<unsigned short> (rand()) % (_height - ya) + ya;
+void Maze::generateGeometry() {
 
-    for (unsigned short x = xa; x <= xb; x++)
-    {
-        mazeBlockAt(x, ya) = true;
-        mazeBlockAt(x, yb) = true;
-    }
-    for (unsigned short y = ya; y <= yb; y++)
-    {
-        mazeBlockAt(xa, y) = true;
-        mazeBlockAt(xb, y) = true;
-    }
-}
+    const BitGrid &grid = _model.getGrid();
+    MazeMesh mesh;
 
-void Maze::printMaze()
-{
-    for (unsigned short x = 0; x < _width; x++)
-    {
-        for (unsigned short y = 0; y < _height; y++)
-            std::cout << (mazeBlockAt(x, y) ? "##" : "  ");
-        std::cout << std::endl;
-    }
+    /** Chunks are small enough for 16 bit indices */
+    for (int oy = 0; oy < grid.height(); oy += MAZE_CHUNK_BLOCKS)
+        for (int ox = 0; ox < grid.width(); ox += MAZE_CHUNK_BLOCKS)
+        {
+            int w = std::min(MAZE_CHUNK_BLOCKS, grid.width() - ox);
+            int h = std::min(MAZE_CHUNK_BLOCKS, grid.height() - oy);
+
+            mesh.clear();
+            meshMaze(w, h
+                     , [&](int x, int y) { return grid.at(ox + x, oy + y); }
+                     , mesh, ox, oy);
+
+            if (mesh.indices.empty())
+                continue;
+
+            std::vector<unsigned short> indices = mesh.shortIndices();
+            Chunk chunk = {
+                createVao(&mesh.vertices, &mesh.normals, &mesh.texcoords
+                          , indices.data(), indices.size(), GL_UNSIGNED_SHORT)
+                , static_cast<GLsizei> (indices.size())
+                , BoundingBox(QVector3D(ox - 0.5f, -0.5f, oy - 0.5f)
+                              , QVector3D(ox + w - 0.5f, 0.5f, oy + h - 0.5f))
+            };
+
+            _chunks.push_back(chunk);
+        }
 }
 
-void Maze::generate()
+void Maze::enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix)
 {
-    int it = (_width + _height) / 6;
+    QMatrix4x4 model = getModelMatrix();
 
-    for (int i = 0; i < it; i++)
-        addRandomLoop();
+    for (const Chunk &chunk : _chunks)
+        queue.push(DrawItem(&getShader(), &getMaterial(), chunk.vao
+                            , GL_TRIANGLES, chunk.count, GL_UNSIGNED_SHORT, model)
+                   , transformBox(model, chunk.bounds));
 }
 
-void Maze::generateAabb()
+QVector3D Maze::getRandomPos()
 {
-    // Aabb(QVector3D(xa - 0.5f, -0.5f, ya - 0.5f), QVector3D(xa + 0.5f, 0.5f, yb + 0.5f));
-    /** horizontal boxes */
-    for (unsigned short y = 0; y < _height; y++)
-    {
-        std::vector<unsigned short> front;
-        std::vector<unsigned short> back;
+   QVector3D position = _model.getRandomPos() * getModelMatrix();
 
-        for (unsigned short x = 0; x < _width; x++)
-        {
-            bool block = mazeBlockAt(x, y);
-            bool fw = mazeBlockAt(x, y + 1);
-            bool bk = mazeBlockAt(x, y - 1);
-
-            if (!block && fw && front.size() == 0)
-            {
-                front = {x, y};
-            }
-            if ((block || (!block && !fw)) && front.size() > 0)
-            {
-                addObstacle(std::make_shared<Aabb>(
-                                         QVector3D(front.at(0) - 0.5f, -0.5f, front.at(1) - 0.5f)
-                                         , QVector3D((x - 1) + 0.5f, 0.5f, y + 0.5f)
-                                         , DRAW_AABB
-                                         ));
-                front.clear();
-            }
-            if (!block && bk && back.size() == 0)
-            {
-                back = {x, y};
-            }
-            if ((block || (!block && !bk)) && back.size() > 0)
-            {
-                addObstacle(std::make_shared<Aabb>(
-                                         QVector3D(back.at(0) - 0.5f, -0.5f, back.at(1) - 0.5f)
-                                         , QVector3D((x - 1) + 0.5f, 0.5f, y + 0.5f)
-                                         , DRAW_AABB
-                                         ));
-                back.clear();
-            }
-        }
-    }
+   std::cout << "Random position: "
+             << position.x() << ", "
+             << position.y() << ", "
+             << position.x() << std::endl;
 
-    /** vertical boxes */
-    for (unsigned short x = 0; x < _width; x++)
-    {
-        std::vector<unsigned short> front;
-        std::vector<unsigned short> back;
 
-        for (unsigned short y = 0; y < _height; y++)
-        {
-            bool block = mazeBlockAt(x, y);
-            bool fw = mazeBlockAt(x + 1, y);
-            bool bk = mazeBlockAt(x - 1, y);
-
-            if (!block && fw && front.size() == 0)
-            {
-                front = {x, y};
-            }
-            if ((block || (!block && !fw)) && front.size() > 0)
-            {
-                addObstacle(std::make_shared<Aabb>(
-                                         QVector3D(front.at(0) - 0.5f, -0.5f, front.at(1) - 0.5f)
-                                         , QVector3D(x + 0.5f, 0.5f, (y - 1) + 0.5f)
-                                         , DRAW_AABB));
-                front.clear();
-            }
-            if (!block && bk && back.size() == 0)
-            {
-                back = {x, y};
-            }
-            if ((block || (!block && !bk)) && back.size() > 0)
-            {
-                addObstacle(std::make_shared<Aabb>(
-                                         QVector3D(back.at(0) - 0.5f, -0.5f, back.at(1) - 0.5f)
-                                         , QVector3D(x + 0.5f, 0.5f, (y - 1) + 0.5f)
-                                         , DRAW_AABB));
-                back.clear();
-            }
-        }
-    }
-
-    /** Outer Wall */// TODO: other sides
-    addObstacle(std::make_shared<Aabb>(
-                             QVector3D(-1 - 0.5f, -0.5f, 0 - 0.5f)
-                             , QVector3D(- 0.5f, 0.5f, _height + 0.5f)
-                             , DRAW_AABB));
-
-    /** Floor */
-    addObstacle(std::make_shared<Aabb>(
-                             QVector3D(0 - 0.5f, -2.f, 0 - 0.5f)
-                             , QVector3D(_width + 0.5f, -0.5f, _height + 0.5f)
-                             , DRAW_AABB));
+   return position;
 }
 
-void Maze::genFace(
-        std::vector<QVector3D> *vertices,
-        std::vector<QVector3D> *normals,
-        std::vector<QVector2D> *texcoords,
-        std::vector<unsigned short> *indices,
-        QMatrix4x4 transform
-        )
+std::vector<QVector3D> Maze::getSpreadPositions(unsigned int count)
 {
+    std::vector<QVector3D> positions = _model.getSpreadPositions(count);
 
-    // 1   2
-    //   c(x, y)
-    // 4   3
-
-    QVector3D a = (transform * QVector3D(+ 0.5f, - 0.5, - 0.5f));
-    QVector3D b = (transform * QVector3D(+ 0.5f, - 0.5, + 0.5f));
-    QVector3D c = (transform * QVector3D(- 0.5f, - 0.5, + 0.5f));
-    QVector3D d = (transform * QVector3D(- 0.5f, - 0.5, - 0.5f));
-
-    QVector2D ta = QVector2D(1.0f, 0.f);
-    QVector2D tb = QVector2D(1.0f, 1.f);
-    QVector2D tc = QVector2D(0.0f, 1.f);
-    QVector2D td = QVector2D(0.0f, 0.f);
-
-    QVector3D normal = (transform * QVector3D(0.f, 1.f, 0.f));
-
-    normal.normalize();
-
-    vertices->push_back(a);// 1
-    vertices->push_back(b);// 2
-    vertices->push_back(c);// 3
-    vertices->push_back(d);// 4
-    normals->push_back(normal);
-    normals->push_back(normal);
-    normals->push_back(normal);
-    normals->push_back(normal);
-    texcoords->push_back(ta);
-    texcoords->push_back(tb);
-    texcoords->push_back(tc);
-    texcoords->push_back(td);
-
-    unsigned short idx = static_cast<unsigned short> (vertices->size() - 1);
-
-    indices->push_back(idx - 1);
-    indices->push_back(idx - 2);
-    indices->push_back(idx - 3);
-
-    indices->push_back(idx - 1);
-    indices->push_back(idx - 3);
-    indices->push_back(idx - 0);
-}
-
-void Maze::generateGeometry() {
+    for (QVector3D &p : positions)
+        p = p * getModelMatrix();
 
-    std::vector<QVector3D> vertices;
-    std::vector<QVector3D> normals;
-    std::vector<QVector2D> texcoords;
-    std::vector<unsigned short> indices;
-
-    for (unsigned short x = 0; x < _width; x++)
-        for (unsigned short y = 0; y < _height; y++)
-            if (mazeBlockAt(x, y))
-            {
-                /** Floor  **/
-                QMatrix4x4 t0 = QMatrix4x4();
-                t0.translate(QVector3D(x, 0, y));
-
-                genFace(&vertices, &normals, &texcoords, &indices, t0);
-
-                 /**  Walls **/
-                if (y + 1 > _height || !mazeBlockAt(x, y + 1))
-                {
-                    QMatrix4x4 t = QMatrix4x4(t0);
-                    t.rotate(-90.f, QVector3D(1, 0, 0));
-
-                    genFace(&vertices, &normals, &texcoords, &indices, t);
-                }
-                if (int(y) - 1 < 0 || !mazeBlockAt(x, y - 1))
-                {
-                    QMatrix4x4 t = QMatrix4x4(t0);
-                    t.rotate(90.0f, QVector3D(1, 0, 0));
-
-                    genFace(&vertices, &normals, &texcoords, &indices, t);
-                }
-                if (x + 1 > _width || !mazeBlockAt(x + 1, y))
-                {
-                    QMatrix4x4 t = QMatrix4x4(t0);
-                    t.rotate(90.0f, QVector3D(0, 0, 1));
-
-                    genFace(&vertices, &normals, &texcoords, &indices, t);
-                }
-                if (int(x) - 1 < 0 || !mazeBlockAt(x - 1, y))
-                {
-                    QMatrix4x4 t = QMatrix4x4(t0);
-                    t.rotate(-90.0f, QVector3D(0, 0, 1));
-
-                    genFace(&vertices, &normals, &texcoords, &indices, t);
-                }
-
-                // {
-                //     QMatrix4x4 t = QMatrix4x4(t0);
-                //     t.rotate(-180.0f, QVector3D(0, 1, 0));
-
-                //     genFace(&vertices, &normals, &texcoords, &indices, t);
-                // }
-            }
-    Drawable::initBuffers(&vertices, &normals, &texcoords, &indices);
+    return positions;
 }
 
-std::vector<bool>::reference Maze::mazeBlockAt(unsigned short x, unsigned short y)
+const BitGrid &Maze::getGrid() const
 {
-    unsigned short idx = y * _width + x;
-
-    if (idx < 0 || idx >= _maze.size())
-        return _maze.at(_maze.size() - 1);
-
-    return _maze.at(idx);
+    return _model.getGrid();
 }
 
-QVector3D Maze::getRandomPos() const
+/**
+ * @brief Maze::flowTo builds the flow field leading to the nearest of the
+ * given world positions; its flow() expects maze coordinates
+ */
+FlowField Maze::flowTo(const std::vector<QVector3D> &targets) const
 {
-   unsigned int idx = 0;
+    std::vector<QVector3D> cells;
+    QMatrix4x4 toMaze = getModelMatrix().inverted();
 
-   for (;_maze.at(idx) != true; idx = static_cast<unsigned int>(rand()) % _maze.size())
-   {
-   }
+    for (QVector3D t : targets)
+        cells.push_back(toMaze * t);
 
-   QVector3D position = QVector3D(idx % _width, 0, idx / _width);
-
-   std::cout << "Random position: "
-             << position.x() << ", "
-             << position.y() << ", "
-             << position.x() << std::endl;
+    return _model.flowTo(cells);
+}
 
+Contact Maze::sweep(BoundingBox box, QVector3D movement)
+{
+    return _model.sweep(box, movement);
+}
 
-   return position * getModelMatrix();
+RayHit Maze::raycast(QVector3D origin, QVector3D direction, float maxTime)
+{
+    return _model.raycast(origin, direction, maxTime);
 }
 
 QVector3D Maze::collision(QVector3D position, QVector3D _movement, BoundingBox observerBox)
 {
     QVector3D shift = QVector3D(_movement.x(), _movement.y(), _movement.z());
-    std::shared_ptr<Aabb> pos0_aabb =
-            std::make_shared<Aabb>(observerBox.a, observerBox.b);
-    std::shared_ptr<Aabb> pos1_aabb =
-            std::make_shared<Aabb>(observerBox.a + shift, observerBox.b + shift);
-
-    bool collides = false;
-    std::vector<std::shared_ptr<Aabb>> aabb_collided;
 
     // std::cout << "observer box: "
     //           << observerBox.b.x() << ", "
     //           << observerBox.b.y() << ", "
     //           << observerBox.b.z() << std::endl;
 
+    return _model.collision(position, shift, observerBox);
+}
 
-    for (std::shared_ptr<Aabb> box : _aabb_list)
-    {
-        bool overlaps = box->hasOverlap(*pos1_aabb);
-
-        collides |= overlaps;
-        box->setCollided(overlaps);
-
-        if (overlaps && box->isObstacle())
-            aabb_collided.push_back(box);
-    }
-
-    if (!collides)
-        return position + shift;
-
-    BVec overlap = BVec(true);
+void Maze::addObstacle(std::shared_ptr<Aabb> obstacle)
+{
+    _model.addObstacle(obstacle);
+    addChild(obstacle);
+}
 
-    for (std::shared_ptr<Aabb> box : aabb_collided)
-    {
-        BVec b = box->getOverlap(*pos0_aabb);
-        overlap &= b;
-    }
-
-    shift = QVector3D(
-                  (overlap.x ? shift.x() : -shift.x())
-                , (overlap.y ? shift.y() : -shift.y())
-                , (overlap.z ? shift.z() : -shift.z())
-                );
+/**
+ * @brief Maze::addTrigger adds a trigger zone with the bounds of trigger,
+ * which is only drawn and does not block movement; returns the trigger id
+ */
+unsigned int Maze::addTrigger(std::shared_ptr<Aabb> trigger, unsigned int tag)
+{
+    unsigned int id = _model.getTriggers().addTrigger(trigger->getBox(), tag);
 
+    addChild(trigger);
 
-    return position + shift;
+    return id;
 }
 
-void Maze::addObstacle(std::shared_ptr<Aabb> obstacle)
+TriggerSystem &Maze::getTriggers()
 {
-    _aabb_list.push_back(obstacle);
-    addChild(obstacle);
+    return _model.getTriggers();
 }
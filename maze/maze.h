@@ -10,37 +10,43 @@
 #include <QMatrix>
 #include <drawable.h>
 #include <aabb.h>
-#include <box.h>
+#include <mazemesh.h>
+#include <mazemodel.h>
 
+/**
+ * @brief The Maze class draws a fixed size maze and wraps its MazeModel
+ *
+ * The geometry is split into chunks of MAZE_CHUNK_BLOCKS x MAZE_CHUNK_BLOCKS
+ * blocks with their own VAO and bounds, so views only draw the chunks inside
+ * their frustum.
+ */
 class Maze : public Drawable
 {
 public:
-    Maze(unsigned short width = 32, unsigned short height = 32);
-    QVector3D getRandomPos() const;
+    Maze(unsigned short width = 32, unsigned short height = 32, uint64_t seed = 0);
+    QVector3D getRandomPos();
+    std::vector<QVector3D> getSpreadPositions(unsigned int count);
+    FlowField flowTo(const std::vector<QVector3D> &targets) const;
+    const BitGrid &getGrid() const;
     QVector3D collision(QVector3D position, QVector3D movement, BoundingBox observerBox);
+    Contact sweep(BoundingBox box, QVector3D movement);
+    RayHit raycast(QVector3D origin, QVector3D direction, float maxTime);
     void addObstacle(std::shared_ptr<Aabb> obstacle);
-    void addButton(std::shared_ptr<Aabb> obstacle);
+    unsigned int addTrigger(std::shared_ptr<Aabb> trigger, unsigned int tag);
+    TriggerSystem &getTriggers();
 
 private:
-    std::vector<bool> _maze;
-    unsigned short _width;
-    unsigned short _height;
-    std::vector<std::shared_ptr<Aabb>> _aabb_list;
-    std::vector<std::shared_ptr<Aabb>> _btn_list;
-    void initMaze();
-    std::vector<bool>::reference mazeBlockAt(unsigned short x, unsigned short y);
-    void addRandomLoop();
-    void generate();
+    struct Chunk {
+        GLuint vao;
+        GLsizei count;
+        BoundingBox bounds;     // maze coordinates
+    };
+
+    virtual void enqueue(RenderQueue &queue, const QMatrix4x4 &vMatrix) override;
     void generateGeometry();
-    void genFace(
-            std::vector<QVector3D> *vertices,
-            std::vector<QVector3D> *normals,
-            std::vector<QVector2D> *texcoords,
-            std::vector<unsigned short> *indices,
-            QMatrix4x4 transform
-            );
-    void generateAabb();
-    void printMaze();
+
+    MazeModel _model;
+    std::vector<Chunk> _chunks;
 signals:
 
 public slots:
@@ -0,0 +1,190 @@
+/*
+ * maze-bench: runs the maze simulation without an OpenGL context and reports
+ * the cost of MazeModel::collision and the trigger tick per frame.
+ *
+ * Usage: maze-bench [frames] [size...]
+ *
+ * For every maze size an observer walks a scripted path (following flow
+ * fields between spread out waypoints) past moving obstacles and trigger
+ * zones for the given number of frames. Maze and path only depend on the fixed seed, so the
+ * numbers are comparable between runs and machines.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <mazemodel.h>
+
+#define BENCH_SEED 1
+#define FRAME_MILLIS 11.f
+#define WALK_SPEED .001f
+#define SIZE 0.1f
+#define OBSTACLES 10
+#define WAYPOINTS 16
+#define TRIGGERS_PER_BLOCK (1.f / 16.f)
+
+/** Counts heap allocations, to catch allocating hot paths */
+static std::atomic<unsigned long> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations++;
+
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+/** Obstacle swinging back and forth along x, like the animated maze boxes */
+class SwingingBox : public Collider
+{
+public:
+    SwingingBox(QVector3D center, float phase): _center(center), _phase(phase) {}
+
+    void step(unsigned int frame)
+    {
+        _offset = 0.3f * std::sin(_phase + frame * 0.05f);
+        _revision++;
+    }
+
+    BoundingBox getBox() const override
+    {
+        QVector3D c = _center + QVector3D(_offset, 0.f, 0.f);
+
+        return BoundingBox(c - QVector3D(0.2f, 0.8f, 0.2f), c + QVector3D(0.2f, 0.2f, 0.5f));
+    }
+    unsigned int getTransformRevision() const override { return _revision; }
+    bool isObstacle() const override { return true; }
+
+private:
+    QVector3D _center;
+    float _phase;
+    float _offset = 0.f;
+    unsigned int _revision = 0;
+};
+
+static double percentile(std::vector<double> sorted, double p)
+{
+    size_t i = static_cast<size_t> (p * (sorted.size() - 1) + 0.5);
+
+    return sorted[i];
+}
+
+static void run(unsigned short size, unsigned int frames)
+{
+    MazeModel model(size, size, BENCH_SEED);
+    std::vector<std::shared_ptr<SwingingBox>> obstacles;
+    std::vector<QVector3D> spots = model.getSpreadPositions(OBSTACLES + WAYPOINTS);
+
+    for (unsigned int i = 0; i < OBSTACLES; i++)
+    {
+        obstacles.push_back(std::make_shared<SwingingBox>(spots[i], i));
+        model.addObstacle(obstacles.back());
+    }
+
+    /** Trigger zones scale with the maze area, independent of the walls */
+    TriggerSystem &triggers = model.getTriggers();
+    unsigned int actor = triggers.addActor();
+    unsigned int events = 0;
+
+    for (QVector3D p : model.getSpreadPositions(static_cast<unsigned int> (size * size * TRIGGERS_PER_BLOCK)))
+        triggers.addTrigger(BoundingBox(p - QVector3D(0.2f, 0.5f, 0.2f), p + QVector3D(0.2f, 0.3f, 0.2f)));
+
+    triggers.addListener([&events](const std::vector<TriggerEvent> &batch)
+    {
+        for (const TriggerEvent &event : batch)
+            events += event.type == TRIGGER_ENTER;
+    });
+
+    std::vector<FlowField> legs;
+
+    for (unsigned int i = 0; i < WAYPOINTS; i++)
+        legs.push_back(model.flowTo({spots[OBSTACLES + i]}));
+
+    QVector3D position = model.getRandomPos();
+    unsigned int leg = 0;
+    std::vector<double> times;
+
+    times.reserve(frames);
+
+    unsigned long allocationsBefore = allocations;
+
+    for (unsigned int frame = 0; frame < frames; frame++)
+    {
+        QVector3D heading = legs[leg].flow(position);
+
+        /** Waypoint reached, head for the next one; the wobble makes the
+         *  observer scrape along walls now and then */
+        if (heading.isNull())
+        {
+            leg = (leg + 1) % WAYPOINTS;
+            heading = legs[leg].flow(position);
+        }
+
+        heading += QVector3D(0.4f * std::sin(frame * 0.1f), 0.f, 0.4f * std::cos(frame * 0.13f));
+
+        QVector3D movement = heading * WALK_SPEED * FRAME_MILLIS;
+        BoundingBox observerBox(position - QVector3D(SIZE, SIZE, SIZE), position + QVector3D(SIZE, SIZE, SIZE));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::shared_ptr<SwingingBox> &obstacle : obstacles)
+            obstacle->step(frame);
+
+        QVector3D moved = model.collision(position, movement, observerBox);
+
+        triggers.moveActor(actor, observerBox, moved - position);
+        triggers.tick();
+        position = moved;
+
+        auto end = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    unsigned long allocated = allocations - allocationsBefore;
+    double total = 0.0;
+
+    for (double t : times)
+        total += t;
+
+    std::sort(times.begin(), times.end());
+
+    std::printf("%5ux%-5u %8u frames %10.0f ns/frame  p50 %8.0f ns  p99 %8.0f ns  %6.2f allocs/frame  %u enters\n"
+                , size, size, frames, total / frames
+                , percentile(times, 0.5), percentile(times, 0.99)
+                , double(allocated) / frames, events);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int frames = argc > 1 ? static_cast<unsigned int> (std::atoi(argv[1])) : 10000;
+    std::vector<unsigned short> sizes;
+
+    for (int i = 2; i < argc; i++)
+        sizes.push_back(static_cast<unsigned short> (std::atoi(argv[i])));
+
+    if (sizes.empty())
+        sizes = {32, 128, 512, 2048};
+
+    for (unsigned short size : sizes)
+        run(size, std::max(frames, 1u));
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <cstddef>
+#include "mazechunk.h"
+
+namespace {
+
+/** SplitMix64 step, used as a stateless hash of (seed, chunk, edge) */
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+uint64_t chunkKey(uint64_t seed, int cx, int cy, uint64_t salt)
+{
+    return mix(seed ^ mix((static_cast<uint64_t> (static_cast<uint32_t> (cx)) << 32)
+                          ^ static_cast<uint32_t> (cy) ^ mix(salt)));
+}
+
+struct ChunkRng {
+    uint64_t state;
+    ChunkRng(uint64_t state): state(state) {}
+    bool coin() { return (mix(state++) & 1) != 0; }
+    unsigned int below(unsigned int n) { return static_cast<unsigned int> (mix(state++) % n); }
+};
+
+}
+
+void generateChunk(uint64_t seed, int cx, int cy, BitGrid &blocks)
+{
+    const int C = CHUNK_CELLS;
+    const int B = CHUNK_BLOCKS;
+    ChunkRng rng(chunkKey(seed, cx, cy, 0));
+    std::vector<int> sets(C);
+    std::vector<int> last(C * C);
+    std::vector<bool> down(C);
+    int nextSet = 0;
+
+    auto open = [&](int x, int y) { blocks.set(x, y, true); };
+
+    blocks.reset(B, B);
+
+    for (int i = 0; i < C; i++)
+        sets[i] = nextSet++;
+
+    for (int j = 0; j < C; j++)
+    {
+        for (int i = 0; i < C; i++)
+            open(2 * i, 2 * j);
+
+        /** Join neighbours of different sets; the last row joins all */
+        for (int i = 0; i + 1 < C; i++)
+        {
+            if (sets[i] == sets[i + 1] || (j + 1 < C && !rng.coin()))
+                continue;
+
+            int from = sets[i + 1];
+
+            for (int k = 0; k < C; k++)
+                if (sets[k] == from)
+                    sets[k] = sets[i];
+
+            open(2 * i + 1, 2 * j);
+        }
+
+        if (j + 1 == C)
+            break;
+
+        /** Every set continues downward through at least one cell */
+        for (int i = 0; i < C; i++)
+            last[static_cast<size_t> (sets[i])] = i;
+
+        std::vector<bool> continued(static_cast<size_t> (nextSet), false);
+
+        for (int i = 0; i < C; i++)
+        {
+            size_t set = static_cast<size_t> (sets[i]);
+
+            down[i] = rng.coin() || (last[set] == i && !continued[set]);
+            continued[set] = continued[set] || down[i];
+
+            if (down[i])
+                open(2 * i, 2 * j + 1);
+        }
+
+        for (int i = 0; i < C; i++)
+            if (!down[i])
+                sets[i] = nextSet++;
+
+        if (nextSet > C * C - C)
+        {
+            /** Renumber so set ids stay within the lookup tables */
+            std::vector<int> map(static_cast<size_t> (nextSet), -1);
+
+            nextSet = 0;
+            for (int i = 0; i < C; i++)
+            {
+                if (map[static_cast<size_t> (sets[i])] < 0)
+                    map[static_cast<size_t> (sets[i])] = nextSet++;
+                sets[i] = map[static_cast<size_t> (sets[i])];
+            }
+        }
+    }
+
+    /** Passages into the east and south neighbour */
+    ChunkRng east(chunkKey(seed, cx, cy, 1));
+    ChunkRng south(chunkKey(seed, cx, cy, 2));
+    unsigned int eastDoor = east.below(C);
+    unsigned int southDoor = south.below(C);
+
+    for (int k = 0; k < C; k++)
+    {
+        if (static_cast<unsigned int> (k) == eastDoor || east.below(4) == 0)
+            open(B - 1, 2 * k);
+        if (static_cast<unsigned int> (k) == southDoor || south.below(4) == 0)
+            open(2 * k, B - 1);
+    }
+}
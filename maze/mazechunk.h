@@ -0,0 +1,23 @@
+#ifndef MAZECHUNK_H
+#define MAZECHUNK_H
+
+#include <cstdint>
+#include <bitgrid.h>
+
+#define CHUNK_CELLS 8
+#define CHUNK_BLOCKS (2 * CHUNK_CELLS)
+
+/**
+ * @brief generateChunk fills blocks with the CHUNK_BLOCKS x CHUNK_BLOCKS
+ * blocks (set = open) of chunk (cx, cy) of the endless maze; the padding
+ * border is left clear
+ *
+ * Each chunk is a perfect maze built row by row with Eller's algorithm. Maze
+ * cells sit on even block coordinates; the odd column and row at the east and
+ * south edge hold the passages into the neighbouring chunks, at least one per
+ * edge. Everything is derived from seed and the chunk coordinates only, so
+ * chunks can be generated in any order, on any process, and always match.
+ */
+void generateChunk(uint64_t seed, int cx, int cy, BitGrid &blocks);
+
+#endif // MAZECHUNK_H
@@ -0,0 +1,177 @@
+#include <limits>
+#include <bitops.hpp>
+#include <rectmerge.h>
+#include "mazemesh.h"
+
+void MazeMesh::clear()
+{
+    vertices.clear();
+    normals.clear();
+    texcoords.clear();
+    indices.clear();
+}
+
+bool MazeMesh::needsIntIndices() const
+{
+    return vertices.size() > std::numeric_limits<unsigned short>::max() + size_t(1);
+}
+
+std::vector<unsigned short> MazeMesh::shortIndices() const
+{
+    return std::vector<unsigned short>(indices.begin(), indices.end());
+}
+
+namespace {
+
+/**
+ * Appends the quad a, b, c, d (in order around its border) with texture
+ * coordinates along the u and v axes given as world coordinate indices.
+ */
+void addQuad(MazeMesh &mesh, QVector3D a, QVector3D b, QVector3D c, QVector3D d
+        , QVector3D normal, int u, int v)
+{
+    unsigned int idx = static_cast<unsigned int> (mesh.vertices.size());
+
+    for (QVector3D p : {a, b, c, d})
+    {
+        mesh.vertices.push_back(p);
+        mesh.normals.push_back(normal);
+        mesh.texcoords.push_back(QVector2D(p[u] + 0.5f, p[v] + 0.5f));
+    }
+
+    mesh.indices.insert(mesh.indices.end(), {
+                            idx + 0, idx + 1, idx + 2
+                            , idx + 0, idx + 2, idx + 3
+                        });
+}
+
+/**
+ * Calls onRun(start, end) for every run of set bits of the row given 64 bits
+ * at a time by word(x), runs crossing word boundaries included.
+ */
+template<typename Word, typename OnRun>
+void forRuns(int width, Word word, OnRun onRun)
+{
+    int start = -1;
+
+    for (int x = 0; x < width; x += 64)
+    {
+        uint64_t bits = word(x) & lowBits(width - x);
+        int pos = 0;
+
+        while (pos < 64)
+        {
+            if (start < 0)
+            {
+                uint64_t rest = bits >> pos;
+
+                if (!rest)
+                    break;
+
+                pos += ctz64(rest);
+                start = x + pos;
+            }
+
+            uint64_t end = ~bits >> pos;
+
+            if (!end)
+                break;
+
+            pos += ctz64(end);
+            onRun(start, x + pos);
+            start = -1;
+        }
+    }
+
+    if (start >= 0)
+        onRun(start, width);
+}
+
+}
+
+void meshMaze(int width, int height, std::function<bool(int, int)> open, MazeMesh &mesh
+        , int offsetX, int offsetY)
+{
+    BitGrid grid(width, height);
+
+    /** Includes the padding border, which decides about the outer walls */
+    for (int y = -1; y <= height; y++)
+        for (int x = -1; x <= width; x++)
+            grid.set(x, y, open(x, y));
+
+    meshMaze(grid, mesh, offsetX, offsetY);
+}
+
+void meshMaze(const BitGrid &open, MazeMesh &mesh, int offsetX, int offsetY)
+{
+    const float lo = -0.5f;
+    const float hi = 0.5f;
+    const int width = open.width();
+    const int height = open.height();
+
+    /** Floor */
+    for (const GridRect &r : mergeRects(open))
+    {
+        float x0 = r.x + offsetX - 0.5f, x1 = x0 + r.w;
+        float z0 = r.y + offsetY - 0.5f, z1 = z0 + r.h;
+
+        addQuad(mesh
+                , QVector3D(x1, lo, z0), QVector3D(x1, lo, z1)
+                , QVector3D(x0, lo, z1), QVector3D(x0, lo, z0)
+                , QVector3D(0.f, 1.f, 0.f), 0, 2);
+    }
+
+    /** Walls facing -z and +z: open blocks whose neighbour row is solid,
+     *  merged along x */
+    for (int y = 0; y < height; y++)
+        for (int side = -1; side <= 1; side += 2)
+        {
+            float z = y + offsetY + side * 0.5f;
+
+            forRuns(width
+                    , [&](int x) { return open.row(x, y) & ~open.row(x, y + side); }
+                    , [&](int start, int end)
+            {
+                float x0 = start + offsetX - 0.5f, x1 = end + offsetX - 0.5f;
+
+                addQuad(mesh
+                        , QVector3D(x0, lo, z), QVector3D(x1, lo, z)
+                        , QVector3D(x1, hi, z), QVector3D(x0, hi, z)
+                        , QVector3D(0.f, 0.f, -side), 0, 1);
+            });
+        }
+
+    /** Walls facing -x and +x, merged along z: a run starts at every face
+     *  whose block above has none */
+    auto face = [&](int x, int y, int side)
+    {
+        return open.row(x, y) & ~open.row(x + side, y);
+    };
+
+    for (int side = -1; side <= 1; side += 2)
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x += 64)
+            {
+                uint64_t starts = face(x, y, side) & lowBits(width - x);
+
+                if (y > 0)
+                    starts &= ~face(x, y - 1, side);
+
+                for (; starts; starts &= starts - 1)
+                {
+                    int bx = x + ctz64(starts);
+                    int n = 1;
+
+                    while (y + n < height && open.get(bx, y + n) && !open.get(bx + side, y + n))
+                        n++;
+
+                    float wx = bx + offsetX + side * 0.5f;
+                    float z0 = y + offsetY - 0.5f, z1 = z0 + n;
+
+                    addQuad(mesh
+                            , QVector3D(wx, lo, z0), QVector3D(wx, lo, z1)
+                            , QVector3D(wx, hi, z1), QVector3D(wx, hi, z0)
+                            , QVector3D(-side, 0.f, 0.f), 2, 1);
+                }
+            }
+}
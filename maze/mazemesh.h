@@ -0,0 +1,48 @@
+#ifndef MAZEMESH_H
+#define MAZEMESH_H
+
+#include <functional>
+#include <vector>
+#include <QVector2D>
+#include <QVector3D>
+#include <bitgrid.h>
+
+/**
+ * @brief Vertex and index data of a maze mesh, ready for Drawable::initBuffers
+ */
+struct MazeMesh {
+    std::vector<QVector3D> vertices;
+    std::vector<QVector3D> normals;
+    std::vector<QVector2D> texcoords;
+    std::vector<unsigned int> indices;
+
+    void clear();
+    bool needsIntIndices() const;
+    std::vector<unsigned short> shortIndices() const;
+};
+
+/**
+ * @brief meshMaze builds greedy-meshed floor and wall geometry for the open
+ * blocks of a width x height grid
+ *
+ * Coplanar neighbouring faces are merged into large quads: floors via
+ * mergeRects, walls as runs along each row/column. Texture coordinates are
+ * derived from world positions, so one texture repeat spans one block and
+ * merged quads look the same as single faces. Block (x, y) is centered at
+ * (x + offsetX, 0, y + offsetY). open() is called with grid coordinates
+ * from -1 to width (height); the blocks just outside of the grid decide about
+ * the outer walls, so return false there for a closed border, or the blocks
+ * of the neighbouring grid when meshing part of a larger maze.
+ */
+void meshMaze(int width, int height, std::function<bool(int, int)> open, MazeMesh &mesh
+        , int offsetX = 0, int offsetY = 0);
+
+/**
+ * @brief meshMaze variant working on a bit grid of open blocks; the padding
+ * border of open holds the blocks just outside of the grid
+ *
+ * Wall faces are classified 64 blocks per word.
+ */
+void meshMaze(const BitGrid &open, MazeMesh &mesh, int offsetX = 0, int offsetY = 0);
+
+#endif // MAZEMESH_H
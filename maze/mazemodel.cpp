@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <bitops.hpp>
+#include "mazemodel.h"
+
+#define MIN_BAND_ROWS 64
+#define PLACEMENT_STREAM ~uint64_t(0)
+
+namespace {
+
+/** Wall used when no factory is given: a plain box */
+class WallCollider : public Collider
+{
+public:
+    WallCollider(const BoundingBox &box): _box(box) {}
+
+    BoundingBox getBox() const override { return _box; }
+    unsigned int getTransformRevision() const override { return 0; }
+    bool isObstacle() const override { return true; }
+
+private:
+    BoundingBox _box;
+};
+
+}
+
+MazeModel::MazeModel(unsigned short width, unsigned short height, uint64_t seed
+                     , WallFactory makeWall) :
+    _width(width), _height(height), _seed(seed)
+    , _placement(seed, PLACEMENT_STREAM)
+{
+    _maze.reset(_width, _height);
+    generate();
+    indexOpenCells();
+    _grid.reset(-0.5f, -0.5f, 1.f, _width, _height);
+    _triggers.reset(-0.5f, -0.5f, 1.f, _width, _height);
+    generateAabb(makeWall);
+    _staticCount = static_cast<unsigned int> (_colliders.size());
+}
+
+unsigned short MazeModel::width() const
+{
+    return _width;
+}
+
+unsigned short MazeModel::height() const
+{
+    return _height;
+}
+
+uint64_t MazeModel::seed() const
+{
+    return _seed;
+}
+
+/**
+ * @brief MazeModel::randomLoop returns the rectangle of the i-th loop, drawn
+ * from its own random stream so that loops do not depend on each other
+ */
+GridRect MazeModel::randomLoop(unsigned int i) const
+{
+    Philox rng(_seed, i);
+    int xa = static_cast<int> (rng.below(std::max(_width / 2, 1)));
+    int xb = static_cast<int> (rng.below(static_cast<uint32_t> (_width - xa))) + xa;
+    int ya = static_cast<int> (rng.below(std::max(_height / 2, 1)));
+    int yb = static_cast<int> (rng.below(static_cast<uint32_t> (_height - ya))) + ya;
+
+    return {xa, ya, xb - xa + 1, yb - ya + 1};
+}
+
+/**
+ * @brief MazeModel::drawLoops draws the outlines of loops into rows y0 up
+ * to, not including, y1
+ */
+void MazeModel::drawLoops(const std::vector<GridRect> &loops, int y0, int y1)
+{
+    for (const GridRect &r : loops)
+    {
+        int top = r.y;
+        int bottom = r.y + r.h - 1;
+
+        if (top >= y0 && top < y1)
+            _maze.setSpan(top, r.x, r.x + r.w, true);
+        if (bottom >= y0 && bottom < y1)
+            _maze.setSpan(bottom, r.x, r.x + r.w, true);
+
+        for (int y = std::max(top, y0); y <= std::min(bottom, y1 - 1); y++)
+        {
+            _maze.set(r.x, y, true);
+            _maze.set(r.x + r.w - 1, y, true);
+        }
+    }
+}
+
+void MazeModel::printMaze() const
+{
+    for (unsigned short x = 0; x < _width; x++)
+    {
+        for (unsigned short y = 0; y < _height; y++)
+            std::cout << (_maze.get(x, y) ? "##" : "  ");
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief MazeModel::generate carves random rectangular loops into the maze
+ *
+ * The loops only depend on the seed. They are drawn in parallel by bands of
+ * rows; every thread owns the words of its rows, and since drawing only sets
+ * bits the result is the same for any number of threads.
+ */
+void MazeModel::generate()
+{
+    unsigned int it = static_cast<unsigned int> (_width + _height) / 6;
+    std::vector<GridRect> loops;
+
+    for (unsigned int i = 0; i < it; i++)
+        loops.push_back(randomLoop(i));
+
+    int bands = std::max(1, std::min(static_cast<int> (std::thread::hardware_concurrency())
+                                     , _height / MIN_BAND_ROWS));
+    std::vector<std::thread> threads;
+
+    for (int b = 1; b < bands; b++)
+        threads.emplace_back(&MazeModel::drawLoops, this, std::cref(loops)
+                             , _height * b / bands, _height * (b + 1) / bands);
+
+    drawLoops(loops, 0, _height / bands);
+
+    for (std::thread &t : threads)
+        t.join();
+}
+
+void MazeModel::generateAabb(WallFactory makeWall)
+{
+    std::vector<BoundingBox> walls;
+
+    /** Solid blocks, merged into as few wall boxes as possible */
+    for (const GridRect &r : mergeRects(_maze.inverted()))
+        walls.push_back(BoundingBox(
+                            QVector3D(r.x - 0.5f, -0.5f, r.y - 0.5f)
+                            , QVector3D(r.x + r.w - 0.5f, 0.5f, r.y + r.h - 0.5f)
+                            ));
+
+    /** Outer Wall */
+    walls.push_back(BoundingBox(
+                        QVector3D(-1 - 0.5f, -0.5f, -1 - 0.5f)
+                        , QVector3D(- 0.5f, 0.5f, _height + 0.5f)));
+    walls.push_back(BoundingBox(
+                        QVector3D(_width - 0.5f, -0.5f, -1 - 0.5f)
+                        , QVector3D(_width + 0.5f, 0.5f, _height + 0.5f)));
+    walls.push_back(BoundingBox(
+                        QVector3D(- 0.5f, -0.5f, -1 - 0.5f)
+                        , QVector3D(_width - 0.5f, 0.5f, - 0.5f)));
+    walls.push_back(BoundingBox(
+                        QVector3D(- 0.5f, -0.5f, _height - 0.5f)
+                        , QVector3D(_width - 0.5f, 0.5f, _height + 0.5f)));
+
+    /** Floor */
+    walls.push_back(BoundingBox(
+                        QVector3D(0 - 0.5f, -2.f, 0 - 0.5f)
+                        , QVector3D(_width + 0.5f, -0.5f, _height + 0.5f)));
+
+    /** The hierarchy reorders the walls; they are stored in that order */
+    _bvh.build(walls, static_cast<unsigned int> (_colliders.size()));
+
+    for (const BoundingBox &box : walls)
+        addCollider(makeWall ? makeWall(box) : std::make_shared<WallCollider>(box));
+}
+
+/**
+ * @brief MazeModel::indexOpenCells lists the open blocks as y * width + x,
+ * read from the grid a word at a time
+ */
+void MazeModel::indexOpenCells()
+{
+    _openCells.clear();
+    _openCells.reserve(_maze.count());
+
+    for (int y = 0; y < _height; y++)
+        for (int x = 0; x < _width; x += 64)
+            for (uint64_t bits = _maze.row(x, y) & lowBits(_width - x); bits; bits &= bits - 1)
+                _openCells.push_back(static_cast<uint32_t> (y) * _width + static_cast<uint32_t> (x + ctz64(bits)));
+}
+
+QVector3D MazeModel::cellPos(uint32_t cell) const
+{
+    return QVector3D(cell % _width, 0, cell / _width);
+}
+
+QVector3D MazeModel::getRandomPos()
+{
+    if (_openCells.empty())
+        return QVector3D();
+
+    return cellPos(_openCells[_placement.below(static_cast<uint32_t> (_openCells.size()))]);
+}
+
+/**
+ * @brief MazeModel::getSpreadPositions returns count open block positions
+ * spread evenly over the maze
+ *
+ * The maze is split into about count strata of similar shape. Strata are
+ * visited in random order, each contributing one of its open blocks drawn
+ * without replacement; empty strata are skipped. Blocks only repeat once all
+ * open blocks have been used.
+ */
+std::vector<QVector3D> MazeModel::getSpreadPositions(unsigned int count)
+{
+    std::vector<QVector3D> positions;
+
+    if (_openCells.empty() || count == 0)
+        return positions;
+
+    int sx = std::max(1, static_cast<int> (std::lround(std::sqrt(float(count) * _width / _height))));
+    int sy = std::max(1, static_cast<int> ((count + sx - 1) / sx));
+    auto stratum = [&](uint32_t cell)
+    {
+        int x = static_cast<int> (cell % _width) * sx / _width;
+        int y = static_cast<int> (cell / _width) * sy / _height;
+        return static_cast<size_t> (y * sx + x);
+    };
+
+    /** Counting sort of the open blocks by stratum */
+    std::vector<uint32_t> first(static_cast<size_t> (sx * sy) + 1, 0);
+    std::vector<uint32_t> cells(_openCells.size());
+
+    for (uint32_t cell : _openCells)
+        first[stratum(cell) + 1]++;
+    for (size_t s = 1; s < first.size(); s++)
+        first[s] += first[s - 1];
+
+    std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+
+    for (uint32_t cell : _openCells)
+        cells[fill[stratum(cell)]++] = cell;
+
+    std::vector<uint32_t> order(first.size() - 1);
+    std::vector<uint32_t> left(order.size());
+
+    for (uint32_t s = 0; s < order.size(); s++)
+    {
+        order[s] = s;
+        left[s] = first[s + 1] - first[s];
+    }
+    for (size_t i = order.size(); i > 1; i--)
+        std::swap(order[i - 1], order[_placement.below(static_cast<uint32_t> (i))]);
+
+    while (positions.size() < count)
+    {
+        size_t before = positions.size();
+
+        for (size_t i = 0; i < order.size() && positions.size() < count; i++)
+        {
+            uint32_t s = order[i];
+
+            if (left[s] == 0)
+                continue;
+
+            uint32_t *slice = &cells[first[s]];
+            uint32_t pick = _placement.below(left[s]);
+
+            positions.push_back(cellPos(slice[pick]));
+            std::swap(slice[pick], slice[--left[s]]);
+        }
+
+        /** Every open block was used, start over */
+        if (positions.size() == before)
+            for (uint32_t s = 0; s < order.size(); s++)
+                left[s] = first[s + 1] - first[s];
+    }
+
+    return positions;
+}
+
+const BitGrid &MazeModel::getGrid() const
+{
+    return _maze;
+}
+
+bool MazeModel::isOpen(int x, int y) const
+{
+    return _maze.at(x, y);
+}
+
+/**
+ * @brief MazeModel::flowTo builds the flow field leading to the nearest of
+ * the given positions
+ */
+FlowField MazeModel::flowTo(const std::vector<QVector3D> &targets) const
+{
+    FlowField field;
+
+    field.build(_maze, targets);
+
+    return field;
+}
+
+void MazeModel::syncColliders()
+{
+#ifndef NDEBUG
+    /** The hierarchy holds the static boxes as they were generated */
+    for (unsigned int i = 0; i < _staticCount; i++)
+        assert(_colliders[i]->getTransformRevision() == _revisions[i]);
+#endif
+
+    /** Boxes added after generation may have moved since the last query */
+    for (unsigned int i = _staticCount; i < _colliders.size(); i++)
+    {
+        std::shared_ptr<Collider> &collider = _colliders.at(i);
+
+        if (collider->getTransformRevision() == _revisions.at(i))
+            continue;
+
+        BoundingBox box = collider->getBox();
+
+        _store.set(i, box);
+        _grid.update(i, box);
+        _revisions.at(i) = collider->getTransformRevision();
+    }
+}
+
+/**
+ * @brief MazeModel::queryColliders collects the ids of all colliders
+ * overlapping box, static ones from the hierarchy and movable ones from the
+ * grid
+ */
+void MazeModel::queryColliders(const BoundingBox &box, std::vector<unsigned int> &result)
+{
+    syncColliders();
+    result.clear();
+    _bvh.query(box, _store, result);
+    _grid.query(box, _candidates);
+    _store.overlap(box, _candidates.data()
+                   , static_cast<unsigned int> (_candidates.size()), _mask);
+
+    for (unsigned int w = 0; w < _mask.size(); w++)
+        for (uint32_t bits = _mask[w]; bits != 0; bits &= bits - 1)
+            result.push_back(_candidates[w * 32 + static_cast<unsigned int> (ctz(bits))]);
+}
+
+/**
+ * @brief MazeModel::sweep returns the first obstacle hit when moving box
+ * along movement, with the contact time as a fraction of movement
+ */
+Contact MazeModel::sweep(BoundingBox box, QVector3D movement)
+{
+    queryColliders(sweptBox(box, movement), _blockers);
+
+    _blockers.erase(std::remove_if(_blockers.begin(), _blockers.end()
+                                   , [this](unsigned int i) { return !_colliders.at(i)->isObstacle(); })
+                    , _blockers.end());
+
+    return _store.sweep(box, movement, _blockers.data()
+                        , static_cast<unsigned int> (_blockers.size()));
+}
+
+/**
+ * @brief MazeModel::raycast returns the closest collider hit by the ray
+ * within maxTime units of direction
+ */
+RayHit MazeModel::raycast(QVector3D origin, QVector3D direction, float maxTime)
+{
+    syncColliders();
+
+    RayHit hit = _bvh.raycast(origin, direction, maxTime, _store);
+    QVector3D inv = QVector3D(1.f / direction.x(), 1.f / direction.y(), 1.f / direction.z());
+
+    for (unsigned int i = _staticCount; i < _store.size(); i++)
+    {
+        BoundingBox box = _store.get(i);
+        const float min[3] = {box.a.x(), box.a.y(), box.a.z()};
+        const float max[3] = {box.b.x(), box.b.y(), box.b.z()};
+        float t;
+
+        if (Bvh::rayBox(origin, inv, min, max, hit.hit ? hit.time : maxTime, t))
+        {
+            hit.hit = true;
+            hit.time = t;
+            hit.id = i;
+        }
+    }
+
+    return hit;
+}
+
+QVector3D MazeModel::collision(QVector3D position, QVector3D movement, BoundingBox observerBox)
+{
+    /** Move up to the first contact and slide along it with the rest */
+    return position + slideMove(observerBox, movement
+                                , [this](const BoundingBox &box, QVector3D m)
+    {
+        return sweep(box, m);
+    });
+}
+
+void MazeModel::addObstacle(std::shared_ptr<Collider> obstacle)
+{
+    unsigned int id = addCollider(obstacle);
+
+    _grid.insert(id, _store.get(id));
+}
+
+TriggerSystem &MazeModel::getTriggers()
+{
+    return _triggers;
+}
+
+unsigned int MazeModel::addCollider(std::shared_ptr<Collider> collider)
+{
+    unsigned int id = _store.add(collider->getBox());
+
+    _revisions.push_back(collider->getTransformRevision());
+    _colliders.push_back(collider);
+
+    return id;
+}
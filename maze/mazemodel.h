@@ -0,0 +1,83 @@
+#ifndef MAZEMODEL_H
+#define MAZEMODEL_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <QVector3D>
+#include <boundingbox.h>
+#include <collider.h>
+#include <uniformgrid.h>
+#include <aabbstore.h>
+#include <bvh.h>
+#include <rectmerge.h>
+#include <bitgrid.h>
+#include <philox.hpp>
+#include <flowfield.h>
+#include <triggersystem.h>
+
+/**
+ * @brief The MazeModel class is the simulation side of the maze: block grid
+ * generation, colliders and collision queries, trigger zones, spawn placement
+ *
+ * It needs no OpenGL context, so it runs in headless tools like maze-bench.
+ * Positions are in maze coordinates: block (x, y) is centered at (x, 0, y).
+ * The wall colliders made during generation are static: their boxes are
+ * read once into a bounding volume hierarchy, so whatever positions them
+ * (the Maze drawable) must keep an identity transform. Debug builds assert
+ * that they never move; obstacles added later may move freely.
+ */
+class MazeModel
+{
+public:
+    typedef std::function<std::shared_ptr<Collider>(const BoundingBox &)> WallFactory;
+
+    MazeModel(unsigned short width = 32, unsigned short height = 32, uint64_t seed = 0
+            , WallFactory makeWall = WallFactory());
+
+    unsigned short width() const;
+    unsigned short height() const;
+    uint64_t seed() const;
+    const BitGrid &getGrid() const;
+    bool isOpen(int x, int y) const;
+    QVector3D getRandomPos();
+    std::vector<QVector3D> getSpreadPositions(unsigned int count);
+    FlowField flowTo(const std::vector<QVector3D> &targets) const;
+    QVector3D collision(QVector3D position, QVector3D movement, BoundingBox observerBox);
+    Contact sweep(BoundingBox box, QVector3D movement);
+    RayHit raycast(QVector3D origin, QVector3D direction, float maxTime);
+    void addObstacle(std::shared_ptr<Collider> obstacle);
+    TriggerSystem &getTriggers();
+    void printMaze() const;
+
+private:
+    GridRect randomLoop(unsigned int i) const;
+    void drawLoops(const std::vector<GridRect> &loops, int y0, int y1);
+    void generate();
+    void indexOpenCells();
+    QVector3D cellPos(uint32_t cell) const;
+    void generateAabb(WallFactory makeWall);
+    void syncColliders();
+    void queryColliders(const BoundingBox &box, std::vector<unsigned int> &result);
+    unsigned int addCollider(std::shared_ptr<Collider> collider);
+
+    BitGrid _maze;
+    unsigned short _width;
+    unsigned short _height;
+    uint64_t _seed;
+    Philox _placement;
+    std::vector<uint32_t> _openCells;
+    std::vector<std::shared_ptr<Collider>> _colliders;
+    UniformGrid _grid;
+    TriggerSystem _triggers;
+    AabbStore _store;
+    Bvh _bvh;
+    unsigned int _staticCount = 0;
+    std::vector<unsigned int> _revisions;
+    std::vector<unsigned int> _candidates;
+    std::vector<uint32_t> _mask;
+    std::vector<unsigned int> _blockers;
+};
+
+#endif // MAZEMODEL_H
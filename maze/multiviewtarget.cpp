@@ -0,0 +1,112 @@
+#include <QOpenGLContext>
+#include "multiviewtarget.h"
+
+#ifndef GL_MAX_VIEWS_OVR
+#define GL_MAX_VIEWS_OVR 0x9631
+#endif
+
+namespace {
+
+typedef void (QOPENGLF_APIENTRYP FramebufferTextureMultiviewOVR)(
+        GLenum target, GLenum attachment, GLuint texture, GLint level
+        , GLint baseViewIndex, GLsizei numViews);
+
+FramebufferTextureMultiviewOVR framebufferTextureMultiview()
+{
+    return reinterpret_cast<FramebufferTextureMultiviewOVR> (
+                QOpenGLContext::currentContext()->getProcAddress("glFramebufferTextureMultiviewOVR"));
+}
+
+}
+
+/**
+ * @brief MultiviewTarget::supported tells whether the current context can
+ * draw MAX_VIEWS views per draw call
+ */
+bool MultiviewTarget::supported()
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    GLint views = 0;
+
+    if (!context->hasExtension("GL_OVR_multiview2") || !framebufferTextureMultiview())
+        return false;
+
+    context->extraFunctions()->glGetIntegerv(GL_MAX_VIEWS_OVR, &views);
+
+    return views >= MAX_VIEWS;
+}
+
+void MultiviewTarget::resize(int width, int height, GLenum format)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (_fbo == 0)
+    {
+        f->glGenFramebuffers(1, &_fbo);
+        f->glGenFramebuffers(1, &_readFbo);
+        f->glGenFramebuffers(1, &_drawFbo);
+    }
+
+    /** Immutable storage, so a new size or format needs new textures */
+    if (_colorTex != 0)
+    {
+        f->glDeleteTextures(1, &_colorTex);
+        f->glDeleteTextures(1, &_depthTex);
+    }
+
+    f->glGenTextures(1, &_colorTex);
+    f->glBindTexture(GL_TEXTURE_2D_ARRAY, _colorTex);
+    f->glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, format, width, height, MAX_VIEWS);
+    f->glGenTextures(1, &_depthTex);
+    f->glBindTexture(GL_TEXTURE_2D_ARRAY, _depthTex);
+    f->glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT24, width, height, MAX_VIEWS);
+    f->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    framebufferTextureMultiview()(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _colorTex, 0, 0, MAX_VIEWS);
+    framebufferTextureMultiview()(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _depthTex, 0, 0, MAX_VIEWS);
+
+    _width = width;
+    _height = height;
+    _format = format;
+}
+
+/**
+ * @brief MultiviewTarget::bind makes the layered framebuffer, of the given
+ * view size and texture format, the draw target and clears it
+ */
+void MultiviewTarget::bind(int width, int height, GLenum format)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (width != _width || height != _height || format != _format)
+        resize(width, height, format);
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    f->glViewport(0, 0, width, height);
+    f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+/**
+ * @brief MultiviewTarget::resolve copies layer i into textures[i]
+ */
+void MultiviewTarget::resolve(const unsigned int *textures)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    f->glBindFramebuffer(GL_READ_FRAMEBUFFER, _readFbo);
+    f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _drawFbo);
+
+    for (int view = 0; view < MAX_VIEWS; view++)
+    {
+        f->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _colorTex, 0, view);
+        f->glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
+        f->glBlitFramebuffer(0, 0, _width, _height, 0, 0, _width, _height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    /** The depth layers are not needed after drawing */
+    const GLenum invalidations[] = { GL_DEPTH_ATTACHMENT };
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    f->glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, invalidations);
+}
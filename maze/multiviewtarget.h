@@ -0,0 +1,36 @@
+#ifndef MULTIVIEWTARGET_H
+#define MULTIVIEWTARGET_H
+
+#include <QOpenGLExtraFunctions>
+#include <uniformblocks.hpp>
+
+/**
+ * @brief The MultiviewTarget class is a framebuffer with MAX_VIEWS layers
+ * that GL_OVR_multiview2 programs draw all views into at once
+ *
+ * QVR hands out one 2D texture per view, so after drawing, resolve() copies
+ * each layer into the texture of its view. The layers have the format of the
+ * view textures, so both paths store and blend colour the same way.
+ */
+class MultiviewTarget
+{
+public:
+    static bool supported();
+
+    void bind(int width, int height, GLenum format = GL_SRGB8_ALPHA8);
+    void resolve(const unsigned int *textures);
+
+private:
+    void resize(int width, int height, GLenum format);
+
+    GLuint _fbo = 0;
+    GLuint _readFbo = 0;
+    GLuint _drawFbo = 0;
+    GLuint _colorTex = 0;
+    GLuint _depthTex = 0;
+    int _width = 0;
+    int _height = 0;
+    GLenum _format = 0;
+};
+
+#endif // MULTIVIEWTARGET_H
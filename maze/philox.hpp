@@ -0,0 +1,81 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <cstdint>
+
+/**
+ * @brief The Philox class is the Philox4x32-10 counter-based random number
+ * generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+ *
+ * Every 128 bit block is a pure function of (seed, stream, counter), so
+ * independent streams can be drawn from in any order or on any thread and
+ * still give the same numbers for the same seed.
+ */
+class Philox
+{
+public:
+    Philox(uint64_t seed = 0, uint64_t stream = 0):
+        _key{static_cast<uint32_t> (seed), static_cast<uint32_t> (seed >> 32)}
+      , _stream(stream)
+    {}
+
+    /** Block number counter of the stream */
+    static void block(uint64_t seed, uint64_t stream, uint64_t counter, uint32_t out[4])
+    {
+        uint32_t k0 = static_cast<uint32_t> (seed);
+        uint32_t k1 = static_cast<uint32_t> (seed >> 32);
+        uint32_t c[4] = {
+            static_cast<uint32_t> (counter), static_cast<uint32_t> (counter >> 32)
+            , static_cast<uint32_t> (stream), static_cast<uint32_t> (stream >> 32)
+        };
+
+        for (int round = 0; round < 10; round++)
+        {
+            uint64_t p0 = uint64_t(0xD2511F53) * c[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57) * c[2];
+            uint32_t n[4] = {
+                static_cast<uint32_t> (p1 >> 32) ^ c[1] ^ k0
+                , static_cast<uint32_t> (p1)
+                , static_cast<uint32_t> (p0 >> 32) ^ c[3] ^ k1
+                , static_cast<uint32_t> (p0)
+            };
+
+            c[0] = n[0]; c[1] = n[1]; c[2] = n[2]; c[3] = n[3];
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+
+        out[0] = c[0]; out[1] = c[1]; out[2] = c[2]; out[3] = c[3];
+    }
+
+    uint32_t next()
+    {
+        if (_used == 4)
+        {
+            block(static_cast<uint64_t> (_key[1]) << 32 | _key[0], _stream, _counter++, _out);
+            _used = 0;
+        }
+
+        return _out[_used++];
+    }
+
+    /** Uniform in [0, n) for n > 0 */
+    uint32_t below(uint32_t n)
+    {
+        return static_cast<uint32_t> ((static_cast<uint64_t> (next()) * n) >> 32);
+    }
+
+    bool coin()
+    {
+        return (next() & 1) != 0;
+    }
+
+private:
+    uint32_t _key[2];
+    uint64_t _stream;
+    uint64_t _counter = 0;
+    uint32_t _out[4];
+    unsigned int _used = 4;
+};
+
+#endif // PHILOX_HPP
@@ -0,0 +1,50 @@
+#include <bitops.hpp>
+#include "rectmerge.h"
+
+std::vector<GridRect> mergeRects(int width, int height, std::function<bool(int, int)> solid)
+{
+    BitGrid grid(width, height);
+
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            grid.set(x, y, solid(x, y));
+
+    return mergeRects(grid);
+}
+
+std::vector<GridRect> mergeRects(const BitGrid &solid)
+{
+    std::vector<GridRect> rects;
+    BitGrid free = solid;
+    int width = solid.width();
+    int height = solid.height();
+
+    /** Covered cells are cleared from free, 64 cells are scanned at a time */
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; )
+        {
+            uint64_t bits = free.row(x, y) & lowBits(width - x);
+
+            if (!bits)
+            {
+                x += 64;
+                continue;
+            }
+
+            x += ctz64(bits);
+
+            int w = free.runLength(x, y, width - x);
+            int h = 1;
+
+            while (y + h < height && free.allSet(x, y + h, w))
+                h++;
+
+            for (int j = 0; j < h; j++)
+                free.setSpan(y + j, x, x + w, false);
+
+            rects.push_back({x, y, w, h});
+            x += w;
+        }
+
+    return rects;
+}
@@ -0,0 +1,29 @@
+#ifndef RECTMERGE_H
+#define RECTMERGE_H
+
+#include <functional>
+#include <vector>
+#include <bitgrid.h>
+
+/**
+ * @brief A rectangle of grid cells, x/y being the cell with the lowest
+ * coordinates
+ */
+struct GridRect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+/**
+ * @brief mergeRects covers all cells for which solid returns true with a
+ * small set of non-overlapping rectangles
+ *
+ * Greedy: every uncovered solid cell in scan order starts a rectangle that is
+ * first grown along x, then along y as long as whole rows stay solid.
+ */
+std::vector<GridRect> mergeRects(int width, int height, std::function<bool(int, int)> solid);
+std::vector<GridRect> mergeRects(const BitGrid &solid);
+
+#endif // RECTMERGE_H
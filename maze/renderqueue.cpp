@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <cstring>
+#include "renderqueue.h"
+#include "frustum.h"
+#include "shadercache.h"
+
+#define FENCE_TIMEOUT 1000000000 // ns
+
+void RenderQueue::clear()
+{
+    /** The draws of the last frame are all issued now; fence their segment
+     *  and move on to the next one */
+    if (_segmentUsed)
+    {
+        QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+        _fences[_segment] = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _segment = (_segment + 1) % RING_SEGMENTS;
+        _segmentUsed = false;
+    }
+
+    _items.clear();
+    _order.clear();
+    _programs.keys.clear();
+    _programs.index.clear();
+    _materials.keys.clear();
+    _materials.index.clear();
+}
+
+/**
+ * @brief RenderQueue::slot returns the index of p in seen, appending it on
+ * first sight
+ */
+unsigned int RenderQueue::slot(Slots &seen, const void *p)
+{
+    auto it = seen.index.insert(std::make_pair(p, static_cast<unsigned int> (seen.keys.size())));
+
+    if (it.second)
+        seen.keys.push_back(p);
+
+    return it.first->second;
+}
+
+GLsizeiptr RenderQueue::align(GLsizeiptr size, GLint alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+void RenderQueue::push(const DrawItem &item)
+{
+    uint64_t program = slot(_programs, item.program);
+    uint64_t material = item.material ? slot(_materials, item.material) + 1 : 0;
+    uint64_t key = program << 56 | (material & 0xffffff) << 32 | item.vao;
+
+    _order.push_back(std::make_pair(key, static_cast<unsigned int> (_items.size())));
+    _items.push_back(item);
+}
+
+/**
+ * @brief RenderQueue::push variant for items with world space bounds, which
+ * submit() culls against the frustum of each view
+ */
+void RenderQueue::push(const DrawItem &item, const BoundingBox &bounds)
+{
+    push(item);
+    _items.back().bounded = true;
+    _items.back().bounds = bounds;
+}
+
+unsigned int RenderQueue::size() const
+{
+    return static_cast<unsigned int> (_items.size());
+}
+
+/**
+ * @brief RenderQueue::drawn returns the number of items the last submit()
+ * drew, after culling
+ */
+unsigned int RenderQueue::drawn() const
+{
+    return _drawn;
+}
+
+void RenderQueue::initBuffers(QOpenGLExtraFunctions *f)
+{
+    GLint alignment = 1;
+
+    f->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    _objectStride = align(sizeof(ObjectBlock), alignment);
+    _materialStride = align(sizeof(MaterialBlock), alignment);
+
+    f->glGenBuffers(1, &_cameraBuf);
+    f->glGenBuffers(1, &_objectBuf);
+    f->glGenBuffers(1, &_materialBuf);
+}
+
+/**
+ * @brief RenderQueue::initProgram attaches the uniform blocks of program to
+ * their binding points and its samplers to their texture units; both never
+ * change, so this happens once per program
+ */
+void RenderQueue::initProgram(QOpenGLExtraFunctions *f, QOpenGLShaderProgram *program)
+{
+    static const char *blocks[] = {"Camera", "Object", "Material"};
+    static const GLuint bindings[] = {CAMERA_BLOCK, OBJECT_BLOCK, MATERIAL_BLOCK};
+    GLuint id = program->programId();
+
+    for (int i = 0; i < 3; i++)
+    {
+        GLuint index = f->glGetUniformBlockIndex(id, blocks[i]);
+
+        if (index != GL_INVALID_INDEX)
+            f->glUniformBlockBinding(id, index, bindings[i]);
+    }
+
+    program->setUniformValue("material_diff_tex", 0);
+    program->setUniformValue("material_norm_tex", 1);
+    program->setUniformValue("material_spec_tex", 2);
+    _initialized.push_back(program);
+}
+
+/**
+ * @brief RenderQueue::streamObjects writes the object block of every item,
+ * in submission order, into the current ring segment
+ */
+void RenderQueue::streamObjects(QOpenGLExtraFunctions *f)
+{
+    unsigned int count = size();
+
+    f->glBindBuffer(GL_UNIFORM_BUFFER, _objectBuf);
+
+    if (count > _objectCapacity)
+    {
+        /** Reallocating orphans the old storage, so pending fences no
+         *  longer matter */
+        for (GLsync &fence : _fences)
+        {
+            if (fence)
+                f->glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        _objectCapacity = std::max(count, 2 * _objectCapacity);
+        f->glBufferData(GL_UNIFORM_BUFFER, RING_SEGMENTS * _objectCapacity * _objectStride
+                        , nullptr, GL_STREAM_DRAW);
+    }
+
+    GLsync &fence = _fences[_segment];
+
+    if (fence)
+    {
+        while (f->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+            ;
+        f->glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    _segmentUsed = true;
+
+    if (count == 0)
+        return;
+
+    char *data = static_cast<char *> (f->glMapBufferRange(
+                GL_UNIFORM_BUFFER, _segment * _objectCapacity * _objectStride, count * _objectStride
+                , GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+    if (!data)
+        return;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const DrawItem &item = _items[_order[i].second];
+        ObjectBlock *block = reinterpret_cast<ObjectBlock *> (data + i * _objectStride);
+
+        std::memcpy(block->model, item.model.constData(), sizeof(block->model));
+        block->color[0] = item.color.x();
+        block->color[1] = item.color.y();
+        block->color[2] = item.color.z();
+        block->color[3] = 1.f;
+    }
+
+    f->glUnmapBuffer(GL_UNIFORM_BUFFER);
+}
+
+/**
+ * @brief RenderQueue::updateMaterials uploads the materials of this frame
+ * into the slots given by their order of first sight, skipping slots that
+ * already hold the same block
+ */
+void RenderQueue::updateMaterials(QOpenGLExtraFunctions *f)
+{
+    f->glBindBuffer(GL_UNIFORM_BUFFER, _materialBuf);
+
+    for (unsigned int i = 0; i < _materials.keys.size(); i++)
+    {
+        const Material &m = *static_cast<const Material *> (_materials.keys[i]);
+        MaterialBlock block = {
+            {m.r, m.g, m.b, 1.f}
+            , {m.kd, m.ks, m.shininess, m.texCoordFactor}
+            , {m.diffTex != 0, m.normTex != 0, m.specTex != 0, 0}
+        };
+
+        if (i < _materialBlocks.size() && std::memcmp(&_materialBlocks[i], &block, sizeof(block)) == 0)
+            continue;
+
+        if (i == _materialBlocks.size())
+            _materialBlocks.push_back(block);
+
+        _materialBlocks[i] = block;
+
+        if (_materialBlocks.size() > _materialCapacity)
+        {
+            /** Grow and upload everything again */
+            _materialCapacity = std::max(2 * _materialCapacity, 16u);
+            f->glBufferData(GL_UNIFORM_BUFFER, _materialCapacity * _materialStride, nullptr, GL_STATIC_DRAW);
+
+            for (unsigned int j = 0; j < _materialBlocks.size(); j++)
+                f->glBufferSubData(GL_UNIFORM_BUFFER, j * _materialStride, sizeof(MaterialBlock), &_materialBlocks[j]);
+        }
+        else
+        {
+            f->glBufferSubData(GL_UNIFORM_BUFFER, i * _materialStride, sizeof(MaterialBlock), &block);
+        }
+    }
+}
+
+/**
+ * @brief RenderQueue::prepare sorts the items and uploads their per object
+ * and material data; call once per frame, before submitting the views
+ */
+void RenderQueue::prepare()
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (_cameraBuf == 0)
+        initBuffers(f);
+
+    std::sort(_order.begin(), _order.end());
+    streamObjects(f);
+    updateMaterials(f);
+    f->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void RenderQueue::bindTextures(QOpenGLExtraFunctions *f, const Material &m, GLuint *textures)
+{
+    const GLuint wanted[3] = {m.diffTex, m.normTex, m.specTex};
+
+    for (int unit = 0; unit < 3; unit++)
+    {
+        if (textures[unit] == wanted[unit])
+            continue;
+
+        f->glActiveTexture(GL_TEXTURE0 + unit);
+        f->glBindTexture(GL_TEXTURE_2D, wanted[unit]);
+        textures[unit] = wanted[unit];
+    }
+}
+
+void RenderQueue::submit(const QMatrix4x4 &vMatrix, const QMatrix4x4 &pMatrix)
+{
+    submit(&vMatrix, &pMatrix, 1);
+}
+
+/**
+ * @brief RenderQueue::submit draws all items in sorted order, changing
+ * program, material and VAO only where the sorted sequence does; bounded
+ * items outside of the frusta of all views are skipped
+ *
+ * With more than one view, the bound framebuffer must have that many
+ * multiview layers and items are drawn with their multiview programs.
+ */
+void RenderQueue::submit(const QMatrix4x4 *vMatrices, const QMatrix4x4 *pMatrices, int views)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    QOpenGLShaderProgram *source = nullptr;
+    QOpenGLShaderProgram *program = nullptr;
+    const Material *material = nullptr;
+    GLuint vao = 0;
+    GLuint textures[3] = {~0u, ~0u, ~0u};
+    CameraBlock camera = {};
+    std::vector<Frustum> frusta;
+
+    for (int v = 0; v < views; v++)
+    {
+        std::memcpy(camera.view[v], vMatrices[v].constData(), sizeof(camera.view[v]));
+        std::memcpy(camera.projection[v], pMatrices[v].constData(), sizeof(camera.projection[v]));
+        frusta.push_back(Frustum(pMatrices[v] * vMatrices[v]));
+    }
+
+    _drawn = 0;
+
+    /** Orphaned per submit, so the previous one can still read its copy */
+    f->glBindBuffer(GL_UNIFORM_BUFFER, _cameraBuf);
+    f->glBufferData(GL_UNIFORM_BUFFER, sizeof(camera), &camera, GL_STREAM_DRAW);
+    f->glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK, _cameraBuf);
+
+    GLintptr segment = _segment * _objectCapacity * _objectStride;
+
+    for (unsigned int i = 0; i < _order.size(); i++)
+    {
+        const DrawItem &item = _items[_order[i].second];
+
+        if (item.program != source)
+        {
+            source = item.program;
+            program = views > 1 ? ShaderCache::multiview(source) : source;
+            material = nullptr;
+
+            if (program)
+                program->bind();
+
+            if (program && std::find(_initialized.begin(), _initialized.end(), program) == _initialized.end())
+                initProgram(f, program);
+        }
+
+        if (!program)
+            continue;
+
+        if (item.bounded && std::none_of(frusta.begin(), frusta.end(), [&](const Frustum &frustum)
+            {
+                return frustum.intersects(item.bounds);
+            }))
+            continue;
+
+        _drawn++;
+
+        if (item.material && item.material != material)
+        {
+            /** The sort key holds the material slot plus one */
+            GLintptr slot = static_cast<GLintptr> ((_order[i].first >> 32) & 0xffffff) - 1;
+
+            material = item.material;
+            f->glBindBufferRange(GL_UNIFORM_BUFFER, MATERIAL_BLOCK, _materialBuf
+                                 , slot * _materialStride, sizeof(MaterialBlock));
+            bindTextures(f, *material, textures);
+        }
+
+        if (item.vao != vao)
+        {
+            vao = item.vao;
+            f->glBindVertexArray(vao);
+        }
+
+        f->glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK, _objectBuf
+                             , segment + i * _objectStride, sizeof(ObjectBlock));
+
+        if (item.indexType == 0 && item.instances == 1)
+            f->glDrawArrays(item.mode, 0, item.count);
+        else if (item.indexType == 0)
+            f->glDrawArraysInstanced(item.mode, 0, item.count, item.instances);
+        else if (item.instances == 1)
+            f->glDrawElements(item.mode, item.count, item.indexType, nullptr);
+        else
+            f->glDrawElementsInstanced(item.mode, item.count, item.indexType, nullptr, item.instances);
+    }
+
+    f->glBindVertexArray(0);
+    f->glUseProgram(0);
+}
@@ -0,0 +1,117 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <material.h>
+#include <boundingbox.h>
+#include <uniformblocks.hpp>
+
+#define RING_SEGMENTS 3
+
+/**
+ * @brief One draw call together with the state it needs
+ *
+ * Indexed draws set indexType, array draws leave it 0. color is passed to
+ * the shader with the model matrix; flat colored shaders use it instead of
+ * a material. Items pushed with world space bounds are skipped in views
+ * that cannot see them.
+ */
+struct DrawItem {
+    QOpenGLShaderProgram *program;
+    const Material *material;
+    GLuint vao;
+    GLenum mode;
+    GLsizei count;
+    GLenum indexType;
+    GLsizei instances;
+    QVector3D color;
+    QMatrix4x4 model;
+    bool bounded = false;
+    BoundingBox bounds = BoundingBox(QVector3D(), QVector3D());
+    DrawItem(QOpenGLShaderProgram *program, const Material *material, GLuint vao
+             , GLenum mode, GLsizei count, GLenum indexType, const QMatrix4x4 &model
+             , QVector3D color = QVector3D(), GLsizei instances = 1):
+        program(program), material(material), vao(vao)
+      , mode(mode), count(count), indexType(indexType), instances(instances)
+      , color(color), model(model)
+    {}
+};
+
+/**
+ * @brief The RenderQueue class collects the draw items of a frame and submits
+ * them sorted by program, material and VAO
+ *
+ * Sorting is done on 64 bit keys with the program in the top bits, so every
+ * program is bound once, every material set once per program and every VAO
+ * bound once per material.
+ *
+ * Nothing is set by uniform name in the draw loop. Camera matrices go to a
+ * uniform buffer written once per view, materials to a buffer with one slot
+ * per material of the frame that is only written when the material in a slot
+ * is new or changed, and the per draw model matrix
+ * and color to a ring of RING_SEGMENTS frames that prepare() streams once
+ * per frame; each draw binds its slot with glBindBufferRange. Fences keep
+ * the ring from overwriting a segment the GPU still reads.
+ *
+ * Submitting MAX_VIEWS views at once draws every item once with the
+ * multiview variant of its program, into a multiview framebuffer.
+ */
+class RenderQueue
+{
+public:
+    void clear();
+    void push(const DrawItem &item);
+    void push(const DrawItem &item, const BoundingBox &bounds);
+    void prepare();
+    void submit(const QMatrix4x4 &vMatrix, const QMatrix4x4 &pMatrix);
+    void submit(const QMatrix4x4 *vMatrices, const QMatrix4x4 *pMatrices, int views);
+    unsigned int size() const;
+    unsigned int drawn() const;
+
+private:
+    /** Programs or materials of the frame, numbered in order of first sight */
+    struct Slots {
+        std::vector<const void *> keys;
+        std::unordered_map<const void *, unsigned int> index;
+    };
+
+    static unsigned int slot(Slots &seen, const void *p);
+    static GLsizeiptr align(GLsizeiptr size, GLint alignment);
+    void initBuffers(QOpenGLExtraFunctions *f);
+    void initProgram(QOpenGLExtraFunctions *f, QOpenGLShaderProgram *program);
+    void streamObjects(QOpenGLExtraFunctions *f);
+    void updateMaterials(QOpenGLExtraFunctions *f);
+    void bindTextures(QOpenGLExtraFunctions *f, const Material &m, GLuint *textures);
+
+    std::vector<DrawItem> _items;
+    std::vector<std::pair<uint64_t, unsigned int>> _order;
+    Slots _programs;
+    Slots _materials;
+    std::vector<const void *> _initialized;
+    unsigned int _drawn = 0;
+
+    GLuint _cameraBuf = 0;
+
+    /** Object ring: RING_SEGMENTS segments of _objectCapacity slots */
+    GLuint _objectBuf = 0;
+    GLsizeiptr _objectStride = 0;
+    unsigned int _objectCapacity = 0;
+    unsigned int _segment = 0;
+    bool _segmentUsed = false;
+    GLsync _fences[RING_SEGMENTS] = {};
+
+    /** Material buffer: slot i holds material i of _materials, reused
+     *  across frames; _materialBlocks mirrors what was uploaded */
+    GLuint _materialBuf = 0;
+    GLsizeiptr _materialStride = 0;
+    unsigned int _materialCapacity = 0;
+    std::vector<MaterialBlock> _materialBlocks;
+};
+
+#endif // RENDERQUEUE_H
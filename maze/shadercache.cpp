@@ -0,0 +1,168 @@
+#include <map>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QOpenGLExtraFunctions>
+#include "shadercache.h"
+
+#define BINARY_MAGIC 0x51565250 // "QVRP"
+
+namespace {
+
+std::map<QByteArray, std::shared_ptr<QOpenGLShaderProgram>> programs;
+std::map<const QOpenGLShaderProgram *, std::shared_ptr<QOpenGLShaderProgram>> multiviews;
+QString cacheDirectory;
+
+bool binariesSupported()
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    GLint formats = 0;
+
+    f->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    return formats > 0;
+}
+
+}
+
+/**
+ * @brief ShaderCache::setMultiview registers multiview as the variant of
+ * program used for multiview passes
+ */
+void ShaderCache::setMultiview(const QOpenGLShaderProgram *program
+                               , std::shared_ptr<QOpenGLShaderProgram> multiview)
+{
+    multiviews[program] = multiview;
+}
+
+/**
+ * @brief ShaderCache::multiview returns the multiview variant of program, or
+ * nullptr if it has none
+ */
+QOpenGLShaderProgram *ShaderCache::multiview(const QOpenGLShaderProgram *program)
+{
+    auto it = multiviews.find(program);
+
+    return it == multiviews.end() ? nullptr : it->second.get();
+}
+
+void ShaderCache::setDirectory(const QString &directory)
+{
+    cacheDirectory = directory;
+}
+
+QString ShaderCache::directory()
+{
+    if (cacheDirectory.isEmpty())
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders";
+
+    return cacheDirectory;
+}
+
+/**
+ * @brief ShaderCache::key hashes both sources together with the driver
+ * identification, since program binaries only load on the driver that
+ * produced them
+ */
+QByteArray ShaderCache::key(const QString &vertexSource, const QString &fragmentSource)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(reinterpret_cast<const char *> (f->glGetString(GL_VENDOR)));
+    hash.addData(reinterpret_cast<const char *> (f->glGetString(GL_RENDERER)));
+    hash.addData(reinterpret_cast<const char *> (f->glGetString(GL_VERSION)));
+    hash.addData(vertexSource.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(fragmentSource.toUtf8());
+
+    return hash.result().toHex();
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ShaderCache::program(const QString &vertexSource
+                                                           , const QString &fragmentSource)
+{
+    QByteArray hash = key(vertexSource, fragmentSource);
+    auto it = programs.find(hash);
+
+    if (it != programs.end())
+        return it->second;
+
+    bool binaries = binariesSupported();
+    QString path = directory() + "/" + QString::fromLatin1(hash) + ".bin";
+    std::shared_ptr<QOpenGLShaderProgram> prg = std::make_shared<QOpenGLShaderProgram>();
+
+    if (!binaries || !loadBinary(*prg, path))
+    {
+        /** A rejected binary may have left the program in any state */
+        prg = std::make_shared<QOpenGLShaderProgram>();
+        prg->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource);
+        prg->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource);
+
+        if (binaries)
+            QOpenGLContext::currentContext()->extraFunctions()->glProgramParameteri(
+                        prg->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        if (prg->link() && binaries)
+            saveBinary(*prg, path);
+    }
+
+    programs[hash] = prg;
+
+    return prg;
+}
+
+bool ShaderCache::loadBinary(QOpenGLShaderProgram &prg, const QString &path)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream ds(&file);
+    quint32 magic, format;
+    QByteArray binary;
+
+    ds >> magic >> format >> binary;
+
+    if (ds.status() != QDataStream::Ok || magic != BINARY_MAGIC || !prg.create())
+        return false;
+
+    QOpenGLContext::currentContext()->extraFunctions()->glProgramBinary(
+                prg.programId(), format, binary.constData(), binary.size());
+
+    /** Without attached shaders, link() only checks the link status */
+    return prg.link();
+}
+
+void ShaderCache::saveBinary(QOpenGLShaderProgram &prg, const QString &path)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    GLint length = 0;
+    GLenum format = 0;
+
+    f->glGetProgramiv(prg.programId(), GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0)
+        return;
+
+    QByteArray binary(length, '\0');
+
+    f->glGetProgramBinary(prg.programId(), length, &length, &format, binary.data());
+    binary.resize(length);
+
+    /** Processes on the same node may race for the same entry; QSaveFile
+     *  renames into place, so readers never see half a file */
+    QSaveFile file(path);
+
+    if (!QDir().mkpath(directory()) || !file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream ds(&file);
+
+    ds << static_cast<quint32> (BINARY_MAGIC) << static_cast<quint32> (format) << binary;
+    file.commit();
+}
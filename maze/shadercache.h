@@ -0,0 +1,39 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <memory>
+#include <QString>
+#include <QOpenGLShaderProgram>
+
+/**
+ * @brief The ShaderCache class hands out one shared program per distinct
+ * pair of shader sources and keeps linked program binaries on disk
+ *
+ * Programs are keyed by a hash of both (already patched) sources and the GL
+ * vendor, renderer and version, so each permutation and each driver gets its
+ * own entry. On a cache hit the program is created with glProgramBinary and
+ * nothing is compiled; otherwise it is compiled, linked and its binary
+ * written to directory() for the next start. Without binary format support
+ * the disk cache is skipped.
+ *
+ * A program can have a multiview variant, which draws all views of a
+ * multiview framebuffer at once; see setMultiview().
+ */
+class ShaderCache
+{
+public:
+    static std::shared_ptr<QOpenGLShaderProgram> program(const QString &vertexSource
+            , const QString &fragmentSource);
+    static void setMultiview(const QOpenGLShaderProgram *program
+            , std::shared_ptr<QOpenGLShaderProgram> multiview);
+    static QOpenGLShaderProgram *multiview(const QOpenGLShaderProgram *program);
+    static void setDirectory(const QString &directory);
+    static QString directory();
+
+private:
+    static QByteArray key(const QString &vertexSource, const QString &fragmentSource);
+    static bool loadBinary(QOpenGLShaderProgram &prg, const QString &path);
+    static void saveBinary(QOpenGLShaderProgram &prg, const QString &path);
+};
+
+#endif // SHADERCACHE_H
@@ -0,0 +1,134 @@
+#include <map>
+#include <vector>
+#include <algorithm>
+#include "texturecache.h"
+
+namespace {
+
+typedef std::map<QString, std::shared_ptr<Texture>> TextureMap;
+
+TextureMap textures;
+GLsizeiptr textureBudget = TEXTURE_BUDGET;
+GLsizeiptr textureBytes = 0;
+unsigned long requests = 0;
+
+}
+
+Texture::Texture(GLuint name):
+    _name(name)
+{
+}
+
+Texture::~Texture()
+{
+    /** Nothing to delete once the context is gone at exit */
+    if (QOpenGLContext::currentContext())
+        QOpenGLContext::currentContext()->extraFunctions()->glDeleteTextures(1, &_name);
+}
+
+GLuint Texture::name() const
+{
+    return _name;
+}
+
+/**
+ * @brief Texture::bytes estimates the GPU memory of the texture, including
+ * its mipmaps
+ */
+GLsizeiptr Texture::bytes() const
+{
+    return _bytes;
+}
+
+/**
+ * @brief TextureCache::texture returns the cached texture of path, or starts
+ * loading it with placeholder shown until it is there
+ */
+std::shared_ptr<Texture> TextureCache::texture(const QString &path, bool halfSize
+                                               , QRgb placeholder)
+{
+    const QString key = path + (halfSize ? "|half" : "|full");
+    auto it = textures.find(key);
+
+    if (it != textures.end())
+    {
+        it->second->_lastUsed = ++requests;
+        return it->second;
+    }
+
+    /** The loader may finish after the texture was dropped */
+    auto texture = std::make_shared<Texture>(0);
+    std::weak_ptr<Texture> weak = texture;
+
+    texture->_name = TextureLoader::instance()->load(path, halfSize, placeholder
+                                                     , [weak](int width, int height)
+    {
+        std::shared_ptr<Texture> t = weak.lock();
+
+        if (!t)
+            return;
+
+        if (width == 0 || height == 0)
+        {
+            t->_failed = true;
+            return;
+        }
+
+        t->_bytes = static_cast<GLsizeiptr> (width) * height * 4 * 4 / 3;
+        textureBytes += t->_bytes;
+        TextureCache::evict();
+    });
+    texture->_lastUsed = ++requests;
+    textures[key] = texture;
+
+    return texture;
+}
+
+void TextureCache::setBudget(GLsizeiptr bytes)
+{
+    textureBudget = bytes;
+}
+
+GLsizeiptr TextureCache::budget()
+{
+    return textureBudget;
+}
+
+/**
+ * @brief TextureCache::size returns the bytes of all loaded cached textures,
+ * held or not
+ */
+GLsizeiptr TextureCache::size()
+{
+    return textureBytes;
+}
+
+void TextureCache::evict()
+{
+    /** Failed textures only hold a placeholder texel, drop them when unheld */
+    for (auto it = textures.begin(); it != textures.end(); )
+        it = it->second->_failed && it->second.use_count() == 1 ? textures.erase(it) : std::next(it);
+
+    if (textureBytes <= textureBudget)
+        return;
+
+    std::vector<TextureMap::iterator> unused;
+
+    for (auto it = textures.begin(); it != textures.end(); ++it)
+        if (it->second.use_count() == 1 && it->second->_bytes > 0)
+            unused.push_back(it);
+
+    std::sort(unused.begin(), unused.end(), [](TextureMap::iterator a, TextureMap::iterator b)
+    {
+        return a->second->_lastUsed < b->second->_lastUsed;
+    });
+
+    for (TextureMap::iterator it : unused)
+    {
+        if (textureBytes <= textureBudget)
+            break;
+
+        textureBytes -= it->second->_bytes;
+        textures.erase(it);
+    }
+}
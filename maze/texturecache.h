@@ -0,0 +1,58 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <memory>
+#include <QString>
+#include <textureloader.h>
+
+#define TEXTURE_BUDGET (256 * 1024 * 1024) // bytes
+
+/**
+ * @brief A GL texture that is deleted with its last reference
+ */
+class Texture
+{
+public:
+    explicit Texture(GLuint name);
+    ~Texture();
+    Texture(const Texture &) = delete;
+    Texture &operator=(const Texture &) = delete;
+
+    GLuint name() const;
+    GLsizeiptr bytes() const;
+
+private:
+    friend class TextureCache;
+
+    GLuint _name;
+    GLsizeiptr _bytes = 0;      // 0 while the placeholder is shown
+    bool _failed = false;       // the image could not be loaded
+    unsigned long _lastUsed = 0;
+};
+
+/**
+ * @brief The TextureCache class hands out one shared texture per image file
+ * and load options
+ *
+ * Textures are keyed by path and halfSize and loaded through TextureLoader,
+ * so asking for a texture that is cached costs neither a decode nor an
+ * upload. Holders keep a texture alive with the returned shared pointer.
+ * Textures nobody holds stay cached for the next request until the loaded
+ * textures take more than budget() bytes; then evict() deletes unheld ones,
+ * least recently requested first. Textures still being loaded are never
+ * evicted, and held textures may exceed the budget. Textures whose image
+ * failed to load are dropped as soon as nobody holds them, so a later
+ * request tries again.
+ */
+class TextureCache
+{
+public:
+    static std::shared_ptr<Texture> texture(const QString &path, bool halfSize
+            , QRgb placeholder = TEXTURE_PLACEHOLDER_DIFFUSE);
+    static void setBudget(GLsizeiptr bytes);
+    static GLsizeiptr budget();
+    static GLsizeiptr size();
+    static void evict();
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <QElapsedTimer>
+#include <QImage>
+#include "textureloader.h"
+
+std::shared_ptr<TextureLoader> TextureLoader::instance()
+{
+    static std::shared_ptr<TextureLoader> loader = std::make_shared<TextureLoader>();
+
+    return loader;
+}
+
+TextureLoader::TextureLoader():
+    _staging(TEXTURE_STAGING_BUFFERS)
+{
+    for (int i = 0; i < TEXTURE_STAGING_BUFFERS; i++)
+        _freeStaging.push_back(i);
+
+    /** Leave a core to the render thread */
+    unsigned int workers = std::max(1u, std::min(std::thread::hardware_concurrency() - 1
+                                                 , static_cast<unsigned int> (TEXTURE_WORKERS)));
+
+    for (unsigned int i = 0; i < workers; i++)
+        _workers.emplace_back(&TextureLoader::work, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    stop();
+}
+
+/**
+ * @brief TextureLoader::stop drops all images not decoded yet, joins the
+ * workers and deletes the PBO ring; call it while the GL context is still
+ * current and before the application goes away
+ */
+void TextureLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        _queued.clear();
+    }
+    _wake.notify_all();
+
+    for (std::thread &w : _workers)
+        w.join();
+
+    _workers.clear();
+
+    /** Without a context (at exit) the GL objects went with it */
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+
+    if (!context || _pbos[0] == 0)
+        return;
+
+    QOpenGLExtraFunctions *f = context->extraFunctions();
+
+    for (unsigned int i = 0; i < TEXTURE_PBOS; i++)
+    {
+        if (_fences[i])
+            f->glDeleteSync(_fences[i]);
+        _fences[i] = nullptr;
+        _pboSizes[i] = 0;
+    }
+
+    f->glDeleteBuffers(TEXTURE_PBOS, _pbos);
+    std::fill(_pbos, _pbos + TEXTURE_PBOS, 0);
+}
+
+/**
+ * @brief TextureLoader::load creates a texture showing placeholder and queues
+ * filename to replace it; halfSize halves the image, as on GLES
+ *
+ * uploaded is called on the GL thread with the image size when the texture
+ * has been filled, or with 0 x 0 if the image could not be loaded; the
+ * texture then keeps its placeholder.
+ */
+GLuint TextureLoader::load(const QString &filename, bool halfSize, QRgb placeholder
+                           , std::function<void(int, int)> uploaded)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    const GLubyte texel[4] = {
+        static_cast<GLubyte> (qRed(placeholder))
+        , static_cast<GLubyte> (qGreen(placeholder))
+        , static_cast<GLubyte> (qBlue(placeholder))
+        , 255
+    };
+    GLuint tex;
+
+    f->glGenTextures(1, &tex);
+    f->glBindTexture(GL_TEXTURE_2D, tex);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+    Job job;
+    job.filename = filename;
+    job.texture = tex;
+    job.halfSize = halfSize;
+    job.uploaded = uploaded;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queued.push_back(job);
+    }
+    _wake.notify_one();
+
+    return tex;
+}
+
+/**
+ * @brief TextureLoader::pending returns the number of textures that still
+ * show their placeholder
+ */
+unsigned int TextureLoader::pending() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<unsigned int> (_queued.size() + _decoding + _decoded.size());
+}
+
+/**
+ * @brief TextureLoader::work runs on the worker threads; a job only starts
+ * when a staging buffer is free, which bounds the memory of decoded images
+ * waiting for upload
+ */
+void TextureLoader::work()
+{
+    for (;;)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]
+            {
+                return _stopping || (!_queued.empty() && !_freeStaging.empty());
+            });
+
+            if (_stopping)
+                return;
+
+            job = _queued.front();
+            _queued.pop_front();
+            job.staging = _freeStaging.back();
+            _freeStaging.pop_back();
+            _decoding++;
+        }
+
+        bool decoded = decode(job);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _decoding--;
+
+            /** Failures go through upload() too, to report them */
+            if (!decoded)
+            {
+                _freeStaging.push_back(job.staging);
+                job.staging = -1;
+            }
+            _decoded.push_back(job);
+        }
+
+        if (!decoded)
+            _wake.notify_one();
+    }
+}
+
+/**
+ * @brief TextureLoader::decode loads the image of job into its staging
+ * buffer as RGBA8888, bottom row first as GL expects it
+ */
+bool TextureLoader::decode(Job &job)
+{
+    QImage img;
+
+    if (!img.load(job.filename))
+    {
+        std::cerr << "cannot load texture " << job.filename.toStdString() << std::endl;
+        return false;
+    }
+
+    if (job.halfSize)
+        img = img.scaledToWidth(img.width() / 2, Qt::SmoothTransformation);
+    img = img.convertToFormat(QImage::Format_RGBA8888);
+
+    job.width = img.width();
+    job.height = img.height();
+
+    /** Only this worker touches the buffer until upload() releases it */
+    std::vector<unsigned char> &pixels = _staging[job.staging];
+    const size_t row = static_cast<size_t> (job.width) * 4;
+
+    pixels.resize(row * job.height);
+    for (int y = 0; y < job.height; y++)
+        std::memcpy(pixels.data() + (job.height - 1 - y) * row, img.constScanLine(y), row);
+
+    return true;
+}
+
+void TextureLoader::release(int staging)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _freeStaging.push_back(staging);
+    }
+    _wake.notify_one();
+}
+
+/**
+ * @brief TextureLoader::upload fills the textures of decoded images until
+ * budgetNanos have passed; at least one image is uploaded per call if one is
+ * ready and its PBO is free
+ */
+void TextureLoader::upload(qint64 budgetNanos)
+{
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+    QElapsedTimer timer;
+
+    timer.start();
+
+    if (_pbos[0] == 0)
+        f->glGenBuffers(TEXTURE_PBOS, _pbos);
+
+    do
+    {
+        Job job;
+
+        /** Only this thread takes jobs out of _decoded */
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (_decoded.empty())
+                break;
+
+            job = _decoded.front();
+        }
+
+        /** The PBO is still read by an earlier upload, try next frame */
+        if (job.staging >= 0 && _fences[_pbo])
+        {
+            if (f->glClientWaitSync(_fences[_pbo], 0, 0) == GL_TIMEOUT_EXPIRED)
+                break;
+
+            f->glDeleteSync(_fences[_pbo]);
+            _fences[_pbo] = nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _decoded.pop_front();
+        }
+
+        if (job.staging >= 0)
+        {
+            finish(f, job, _pbo);
+            _fences[_pbo] = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            _pbo = (_pbo + 1) % TEXTURE_PBOS;
+        }
+
+        if (job.uploaded)
+            job.uploaded(job.width, job.height);
+    }
+    while (timer.nsecsElapsed() < budgetNanos);
+}
+
+/**
+ * @brief TextureLoader::finish copies the pixels of job into PBO slot,
+ * returns its staging buffer and replaces the placeholder with them
+ */
+void TextureLoader::finish(QOpenGLExtraFunctions *f, const Job &job, unsigned int slot)
+{
+    const std::vector<unsigned char> &pixels = _staging[job.staging];
+    const GLsizeiptr size = static_cast<GLsizeiptr> (pixels.size());
+
+    f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[slot]);
+    if (_pboSizes[slot] < size)
+    {
+        f->glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        _pboSizes[slot] = size;
+    }
+
+    /** The fence already told us the GPU is done with this PBO */
+    void *dst = f->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size
+                                    , GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+                                    | GL_MAP_UNSYNCHRONIZED_BIT);
+    const void *src = nullptr;
+
+    if (dst)
+    {
+        std::memcpy(dst, pixels.data(), pixels.size());
+        f->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    else
+    {
+        /** Mapping failed, upload straight from the staging buffer */
+        f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        src = pixels.data();
+    }
+
+    f->glBindTexture(GL_TEXTURE_2D, job.texture);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+            job.width, job.height, 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, src);
+    f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    release(job.staging);
+
+    f->glGenerateMipmap(GL_TEXTURE_2D);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+    if (!QOpenGLContext::currentContext()->isOpenGLES())
+        f->glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 4.0f);
+}
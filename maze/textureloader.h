@@ -0,0 +1,87 @@
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QOpenGLExtraFunctions>
+#include <QString>
+#include <QRgb>
+
+#define TEXTURE_WORKERS 2
+#define TEXTURE_STAGING_BUFFERS 4
+#define TEXTURE_PBOS 3
+#define TEXTURE_UPLOAD_BUDGET 2000000 // ns per frame
+
+#define TEXTURE_PLACEHOLDER_DIFFUSE qRgb(128, 128, 128)
+#define TEXTURE_PLACEHOLDER_NORMAL qRgb(128, 128, 255)
+#define TEXTURE_PLACEHOLDER_SPECULAR qRgb(0, 0, 0)
+
+/**
+ * @brief The TextureLoader class loads image files into textures without
+ * stalling the render thread
+ *
+ * load() returns a texture name at once; until the image is there the
+ * texture holds a single placeholder texel, so materials can use it right
+ * away. Worker threads decode, scale, flip and convert the image into one of
+ * TEXTURE_STAGING_BUFFERS reused staging buffers, and upload(), called once
+ * per frame on the GL thread, copies finished images into a ring of
+ * TEXTURE_PBOS pixel unpack buffers and fills the textures from there until
+ * its time budget is spent. A fence per PBO keeps an upload from overwriting
+ * pixels the GPU still reads. The optional callback of load() gets the
+ * final size once the image is in, or 0 x 0 if it failed to load. There is
+ * one instance per process, see instance().
+ */
+class TextureLoader
+{
+public:
+    static std::shared_ptr<TextureLoader> instance();
+
+    TextureLoader();
+    ~TextureLoader();
+
+    GLuint load(const QString &filename, bool halfSize
+                , QRgb placeholder = TEXTURE_PLACEHOLDER_DIFFUSE
+                , std::function<void(int, int)> uploaded = nullptr);
+    void upload(qint64 budgetNanos = TEXTURE_UPLOAD_BUDGET);
+    unsigned int pending() const;
+    void stop();
+
+private:
+    struct Job {
+        QString filename;
+        GLuint texture;
+        bool halfSize;
+        std::function<void(int, int)> uploaded;
+        int width = 0;
+        int height = 0;
+        int staging = -1;  // staging buffer holding the pixels, -1 if decoding failed
+    };
+
+    void work();
+    bool decode(Job &job);
+    void finish(QOpenGLExtraFunctions *f, const Job &job, unsigned int slot);
+    void release(int staging);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::vector<std::thread> _workers;
+    bool _stopping = false;
+
+    std::deque<Job> _queued;    // waiting for a worker
+    std::deque<Job> _decoded;   // waiting for upload()
+    unsigned int _decoding = 0;
+    std::vector<std::vector<unsigned char>> _staging;
+    std::vector<int> _freeStaging;
+
+    GLuint _pbos[TEXTURE_PBOS] = {};
+    GLsizeiptr _pboSizes[TEXTURE_PBOS] = {};
+    GLsync _fences[TEXTURE_PBOS] = {};
+    unsigned int _pbo = 0;
+};
+
+#endif // TEXTURELOADER_H
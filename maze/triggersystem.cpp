@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <bitops.hpp>
+#include "triggersystem.h"
+
+TriggerSystem::TriggerSystem(float originX, float originZ, float cellSize, int width, int height)
+{
+    reset(originX, originZ, cellSize, width, height);
+}
+
+void TriggerSystem::reset(float originX, float originZ, float cellSize, int width, int height)
+{
+    _grid.reset(originX, originZ, cellSize, width, height);
+    _store.clear();
+    _tags.clear();
+    _actors.clear();
+    _events.clear();
+    _triggersMoved = false;
+}
+
+unsigned int TriggerSystem::addTrigger(const BoundingBox &box, unsigned int tag)
+{
+    unsigned int id = _store.add(box);
+
+    _tags.push_back(tag);
+    _grid.insert(id, box);
+    _triggersMoved = true;
+
+    return id;
+}
+
+void TriggerSystem::moveTrigger(unsigned int trigger, const BoundingBox &box)
+{
+    _store.set(trigger, box);
+    _grid.update(trigger, box);
+    _triggersMoved = true;
+}
+
+BoundingBox TriggerSystem::getBox(unsigned int trigger) const
+{
+    return _store.get(trigger);
+}
+
+unsigned int TriggerSystem::getTag(unsigned int trigger) const
+{
+    return _tags.at(trigger);
+}
+
+unsigned int TriggerSystem::triggerCount() const
+{
+    return _store.size();
+}
+
+unsigned int TriggerSystem::addActor()
+{
+    _actors.push_back(Actor());
+
+    return static_cast<unsigned int> (_actors.size() - 1);
+}
+
+/**
+ * @brief TriggerSystem::moveActor sets the persistent box of actor; with a
+ * movement, the whole way from box to box + movement counts, so that fast
+ * actors cannot skip over thin triggers
+ */
+void TriggerSystem::moveActor(unsigned int actor, const BoundingBox &box, QVector3D movement)
+{
+    Actor &a = _actors.at(actor);
+    BoundingBox swept = sweptBox(box, movement);
+
+    if (a.placed)
+    {
+        a.boxes[0] = swept;
+    }
+    else
+    {
+        a.boxes.insert(a.boxes.begin(), swept);
+        a.placed = true;
+    }
+
+    a.dirty = true;
+}
+
+/**
+ * @brief TriggerSystem::touch adds a box to actor for the next tick only
+ */
+void TriggerSystem::touch(unsigned int actor, const BoundingBox &box)
+{
+    Actor &a = _actors.at(actor);
+
+    a.boxes.push_back(box);
+    a.dirty = true;
+}
+
+void TriggerSystem::addListener(Listener listener)
+{
+    _listeners.push_back(listener);
+}
+
+/**
+ * @brief TriggerSystem::collect appends the ids of all triggers overlapping
+ * box to _current
+ */
+void TriggerSystem::collect(const BoundingBox &box)
+{
+    _grid.query(box, _candidates);
+    _store.overlap(box, _candidates.data()
+                   , static_cast<unsigned int> (_candidates.size()), _mask);
+
+    for (unsigned int w = 0; w < _mask.size(); w++)
+        for (uint32_t bits = _mask[w]; bits != 0; bits &= bits - 1)
+            _current.push_back(_candidates[w * 32 + static_cast<unsigned int> (ctz(bits))]);
+}
+
+/**
+ * @brief TriggerSystem::tick updates which triggers every actor is in and
+ * delivers the resulting enter/stay/exit events to all listeners at once
+ *
+ * Actors that did not move keep their triggers without a query, unless a
+ * trigger moved.
+ */
+const std::vector<TriggerEvent> &TriggerSystem::tick()
+{
+    _events.clear();
+
+    for (unsigned int id = 0; id < _actors.size(); id++)
+    {
+        Actor &a = _actors[id];
+
+        if (!a.dirty && !_triggersMoved)
+        {
+            for (unsigned int t : a.inside)
+                _events.push_back(TriggerEvent(TRIGGER_STAY, t, id));
+
+            continue;
+        }
+
+        _current.clear();
+
+        for (const BoundingBox &box : a.boxes)
+            collect(box);
+
+        std::sort(_current.begin(), _current.end());
+        _current.erase(std::unique(_current.begin(), _current.end()), _current.end());
+
+        /** Merge the sorted old and new sets */
+        auto was = a.inside.begin();
+        auto is = _current.begin();
+
+        while (was != a.inside.end() || is != _current.end())
+        {
+            if (is == _current.end() || (was != a.inside.end() && *was < *is))
+                _events.push_back(TriggerEvent(TRIGGER_EXIT, *was++, id));
+            else if (was == a.inside.end() || *is < *was)
+                _events.push_back(TriggerEvent(TRIGGER_ENTER, *is++, id));
+            else
+            {
+                _events.push_back(TriggerEvent(TRIGGER_STAY, *is++, id));
+                was++;
+            }
+        }
+
+        a.inside.swap(_current);
+
+        /** Touches expire, so the actor is queried again next tick */
+        auto touches = a.boxes.begin() + (a.placed ? 1 : 0);
+
+        a.dirty = touches != a.boxes.end();
+        a.boxes.erase(touches, a.boxes.end());
+    }
+
+    _triggersMoved = false;
+
+    if (!_events.empty())
+        for (Listener &listener : _listeners)
+            listener(_events);
+
+    return _events;
+}
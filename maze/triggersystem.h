@@ -0,0 +1,82 @@
+#ifndef TRIGGERSYSTEM_H
+#define TRIGGERSYSTEM_H
+
+#include <functional>
+#include <vector>
+#include <boundingbox.h>
+#include <uniformgrid.h>
+#include <aabbstore.h>
+
+enum TriggerEventType {
+    TRIGGER_ENTER,
+    TRIGGER_STAY,
+    TRIGGER_EXIT
+};
+
+struct TriggerEvent {
+    TriggerEventType type;
+    unsigned int trigger;
+    unsigned int actor;
+    TriggerEvent(TriggerEventType type, unsigned int trigger, unsigned int actor):
+        type(type), trigger(trigger), actor(actor)
+    {}
+};
+
+/**
+ * @brief The TriggerSystem class reports actors entering, staying in and
+ * leaving trigger zones such as buttons and goals
+ *
+ * Triggers live in their own grid, apart from the walls, and only actors
+ * that moved since the last tick are tested against the triggers near them.
+ * tick() collects the events of all actors and hands them to the listeners
+ * as one batch, ordered by actor and trigger id.
+ *
+ * An actor has at most one box that persists between ticks (moveActor)
+ * and any number of boxes that only count for the next tick (touch); the
+ * latter let many short contacts share one actor.
+ */
+class TriggerSystem
+{
+public:
+    typedef std::function<void(const std::vector<TriggerEvent> &)> Listener;
+
+    TriggerSystem(float originX = 0.f, float originZ = 0.f, float cellSize = 1.f
+            , int width = 0, int height = 0);
+
+    void reset(float originX, float originZ, float cellSize, int width, int height);
+    unsigned int addTrigger(const BoundingBox &box, unsigned int tag = 0);
+    void moveTrigger(unsigned int trigger, const BoundingBox &box);
+    BoundingBox getBox(unsigned int trigger) const;
+    unsigned int getTag(unsigned int trigger) const;
+    unsigned int triggerCount() const;
+
+    unsigned int addActor();
+    void moveActor(unsigned int actor, const BoundingBox &box, QVector3D movement = QVector3D());
+    void touch(unsigned int actor, const BoundingBox &box);
+
+    void addListener(Listener listener);
+    const std::vector<TriggerEvent> &tick();
+
+private:
+    struct Actor {
+        std::vector<BoundingBox> boxes;  // boxes[0] is the persistent one, if any
+        bool placed = false;
+        bool dirty = false;
+        std::vector<unsigned int> inside;  // sorted trigger ids
+    };
+
+    void collect(const BoundingBox &box);
+
+    UniformGrid _grid;
+    AabbStore _store;
+    std::vector<unsigned int> _tags;
+    bool _triggersMoved = false;
+    std::vector<Actor> _actors;
+    std::vector<Listener> _listeners;
+    std::vector<TriggerEvent> _events;
+    std::vector<unsigned int> _candidates;
+    std::vector<unsigned int> _current;
+    std::vector<uint32_t> _mask;
+};
+
+#endif // TRIGGERSYSTEM_H
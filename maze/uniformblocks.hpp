@@ -0,0 +1,38 @@
+#ifndef UNIFORMBLOCKS_HPP
+#define UNIFORMBLOCKS_HPP
+
+#include <QOpenGLExtraFunctions>
+
+/**
+ * std140 uniform blocks shared by the maze shaders, and the binding points
+ * they are attached to. The layouts must match the GLSL declarations in the
+ * maze-*.glsl, crowd-*.glsl, debugbox-*.glsl and debugdraw-*.glsl shaders.
+ */
+
+#define CAMERA_BLOCK 0
+#define OBJECT_BLOCK 1
+#define MATERIAL_BLOCK 2
+
+/** Views a multiview draw renders at once */
+#define MAX_VIEWS 2
+
+/** Written once per submit, for one view or all views of a multiview pass */
+struct CameraBlock {
+    GLfloat view[MAX_VIEWS][16];
+    GLfloat projection[MAX_VIEWS][16];
+};
+
+/** Streamed once per frame, one per draw */
+struct ObjectBlock {
+    GLfloat model[16];
+    GLfloat color[4];
+};
+
+/** Uploaded when a material is first drawn or has changed */
+struct MaterialBlock {
+    GLfloat color[4];
+    GLfloat params[4];   // kd, ks, shininess, tex coord factor
+    GLint hasTex[4];     // diffuse, normal, specular
+};
+
+#endif // UNIFORMBLOCKS_HPP
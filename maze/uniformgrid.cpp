@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+#include "uniformgrid.h"
+
+#define MAX_CELLS 64
+
+UniformGrid::UniformGrid(float originX, float originZ, float cellSize, int width, int height)
+{
+    reset(originX, originZ, cellSize, width, height);
+}
+
+void UniformGrid::reset(float originX, float originZ, float cellSize, int width, int height)
+{
+    _originX = originX;
+    _originZ = originZ;
+    _cellSize = cellSize;
+    _width = std::max(width, 1);
+    _height = std::max(height, 1);
+
+    _cells.assign(static_cast<size_t> (_width * _height), std::vector<unsigned int>());
+    _large.clear();
+    _ranges.clear();
+    _stamps.clear();
+    _stamp = 0;
+}
+
+UniformGrid::CellRange UniformGrid::cellRange(const BoundingBox &box) const
+{
+    /** Boxes outside of the grid are clamped to the border cells */
+    auto cell = [this](float v, float origin, int count)
+    {
+        int c = static_cast<int> (std::floor((v - origin) / _cellSize));
+        return std::min(std::max(c, 0), count - 1);
+    };
+
+    return {
+        cell(box.a.x(), _originX, _width)
+        , cell(box.a.z(), _originZ, _height)
+        , cell(box.b.x(), _originX, _width)
+        , cell(box.b.z(), _originZ, _height)
+    };
+}
+
+bool UniformGrid::isLarge(const CellRange &range) const
+{
+    return (range.x1 - range.x0 + 1) * (range.z1 - range.z0 + 1) > MAX_CELLS;
+}
+
+void UniformGrid::link(unsigned int id, const CellRange &range)
+{
+    if (isLarge(range))
+    {
+        _large.push_back(id);
+        return;
+    }
+
+    for (int z = range.z0; z <= range.z1; z++)
+        for (int x = range.x0; x <= range.x1; x++)
+            _cells[static_cast<size_t> (z * _width + x)].push_back(id);
+}
+
+void UniformGrid::unlink(unsigned int id, const CellRange &range)
+{
+    auto erase = [id](std::vector<unsigned int> &list)
+    {
+        list.erase(std::remove(list.begin(), list.end(), id), list.end());
+    };
+
+    if (isLarge(range))
+    {
+        erase(_large);
+        return;
+    }
+
+    for (int z = range.z0; z <= range.z1; z++)
+        for (int x = range.x0; x <= range.x1; x++)
+            erase(_cells[static_cast<size_t> (z * _width + x)]);
+}
+
+void UniformGrid::insert(unsigned int id, const BoundingBox &box)
+{
+    if (id >= _ranges.size())
+    {
+        _ranges.resize(id + 1, {0, 0, -1, -1});
+        _stamps.resize(id + 1, 0);
+    }
+
+    CellRange range = cellRange(box);
+
+    _ranges[id] = range;
+    link(id, range);
+}
+
+void UniformGrid::update(unsigned int id, const BoundingBox &box)
+{
+    if (id >= _ranges.size() || _ranges[id].x1 < _ranges[id].x0)
+    {
+        insert(id, box);
+        return;
+    }
+
+    CellRange range = cellRange(box);
+
+    if (range == _ranges[id])
+        return;
+
+    unlink(id, _ranges[id]);
+    _ranges[id] = range;
+    link(id, range);
+}
+
+void UniformGrid::query(const BoundingBox &box, std::vector<unsigned int> &result)
+{
+    result.clear();
+
+    /** Stamps make sure a box spanning several cells is reported once */
+    if (++_stamp == 0)
+    {
+        std::fill(_stamps.begin(), _stamps.end(), 0);
+        _stamp = 1;
+    }
+
+    for (unsigned int id : _large)
+    {
+        _stamps[id] = _stamp;
+        result.push_back(id);
+    }
+
+    CellRange range = cellRange(box);
+
+    for (int z = range.z0; z <= range.z1; z++)
+        for (int x = range.x0; x <= range.x1; x++)
+            for (unsigned int id : _cells[static_cast<size_t> (z * _width + x)])
+                if (_stamps[id] != _stamp)
+                {
+                    _stamps[id] = _stamp;
+                    result.push_back(id);
+                }
+}
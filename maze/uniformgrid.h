@@ -0,0 +1,51 @@
+#ifndef UNIFORMGRID_H
+#define UNIFORMGRID_H
+
+#include <vector>
+#include <boundingbox.h>
+
+/**
+ * @brief The UniformGrid class is a cell-indexed broadphase over the x/z plane
+ *
+ * Boxes are referenced by id and registered in every cell their footprint
+ * covers. Boxes that cover more than MAX_CELLS cells (floor, outer walls) are
+ * kept in a separate list that every query returns.
+ */
+class UniformGrid
+{
+public:
+    UniformGrid(float originX = 0.f, float originZ = 0.f, float cellSize = 1.f
+            , int width = 0, int height = 0);
+
+    void reset(float originX, float originZ, float cellSize, int width, int height);
+    void insert(unsigned int id, const BoundingBox &box);
+    void update(unsigned int id, const BoundingBox &box);
+    void query(const BoundingBox &box, std::vector<unsigned int> &result);
+
+private:
+    struct CellRange {
+        int x0, z0, x1, z1;
+        bool operator ==(const CellRange &r) const
+        {
+            return x0 == r.x0 && z0 == r.z0 && x1 == r.x1 && z1 == r.z1;
+        }
+    };
+
+    CellRange cellRange(const BoundingBox &box) const;
+    bool isLarge(const CellRange &range) const;
+    void link(unsigned int id, const CellRange &range);
+    void unlink(unsigned int id, const CellRange &range);
+
+    float _originX;
+    float _originZ;
+    float _cellSize;
+    int _width;
+    int _height;
+    std::vector<std::vector<unsigned int>> _cells;
+    std::vector<unsigned int> _large;
+    std::vector<CellRange> _ranges;
+    std::vector<unsigned int> _stamps;
+    unsigned int _stamp = 0;
+};
+
+#endif // UNIFORMGRID_H
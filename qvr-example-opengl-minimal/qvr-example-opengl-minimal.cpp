@@ -41,15 +41,6 @@ bool QVRExampleOpenGLMinimal::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // Framebuffer object
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
     // Vertex array object
     static const GLfloat boxPositions[] = {
         -0.8f, +0.8f, +1.0f,   +0.8f, +0.8f, +1.0f,   +0.8f, -0.8f, +1.0f,   -0.8f, -0.8f, +1.0f, // front
@@ -104,20 +95,11 @@ bool QVRExampleOpenGLMinimal::initProcess(QVRProcess* /* p */)
 }
 
 void QVRExampleOpenGLMinimal::render(QVRWindow* /* w */,
-        const QVRRenderContext& context, const unsigned int* textures)
+        const QVRRenderContext& context, const unsigned int* /* textures */)
 {
     for (int view = 0; view < context.viewCount(); view++) {
-        // Get view dimensions
-        int width = context.textureSize(view).width();
-        int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height,
-                0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
-        // Set up view
-        glViewport(0, 0, width, height);
+        // Set up framebuffer object and view
+        context.bindView(view);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         QMatrix4x4 projectionMatrix = context.frustum(view).toMatrix4x4();
         QMatrix4x4 viewMatrix = context.viewMatrix(view);
@@ -134,6 +116,7 @@ void QVRExampleOpenGLMinimal::render(QVRWindow* /* w */,
         _prg.setUniformValue("normal_matrix", modelViewMatrix.normalMatrix());
         glBindVertexArray(_vao);
         glDrawElements(GL_TRIANGLES, _vaoIndices, GL_UNSIGNED_INT, 0);
+        context.finishView();
     }
 }
 
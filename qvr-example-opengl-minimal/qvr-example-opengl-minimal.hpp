@@ -38,8 +38,6 @@ private:
     QElapsedTimer _timer;       // used for rotating the box
 
     /* Static data for rendering, initialized per process. */
-    unsigned int _fbo;          // Framebuffer object to render into
-    unsigned int _fboDepthTex;  // Depth attachment for the FBO
     unsigned int _vao;          // Vertex array object for the box
     unsigned int _vaoIndices;   // Number of indices to render for the box
     QOpenGLShaderProgram _prg;  // Shader program for rendering
@@ -187,17 +187,6 @@ bool QVRExampleOpenGL::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // FBO
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
     // Floor
     geom_quad(positions, normals, texcoords, indices);
     _floorVao = setupVao(positions.size() / 3, positions.data(), normals.data(), texcoords.data(),
@@ -292,20 +281,11 @@ bool QVRExampleOpenGL::initProcess(QVRProcess* /* p */)
 }
 
 void QVRExampleOpenGL::render(QVRWindow* /* w */,
-        const QVRRenderContext& context, const unsigned int* textures)
+        const QVRRenderContext& context, const unsigned int* /* textures */)
 {
     for (int view = 0; view < context.viewCount(); view++) {
-        // Get view dimensions
-        int width = context.textureSize(view).width();
-        int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height,
-                0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
-        // Set up view
-        glViewport(0, 0, width, height);
+        // Set up framebuffer object and view
+        context.bindView(view);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         QMatrix4x4 projectionMatrix = context.frustum(view).toMatrix4x4();
         QMatrix4x4 viewMatrix = context.viewMatrix(view);
@@ -358,9 +338,8 @@ void QVRExampleOpenGL::render(QVRWindow* /* w */,
                         _devModelVaoIndices[vertexDataIndex]);
             }
         }
-        // Invalidate depth attachment (to help OpenGL ES performance)
-        const GLenum fboInvalidations[] = { GL_DEPTH_ATTACHMENT };
-        glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, fboInvalidations);
+        // Resolve and invalidate depth attachment (to help OpenGL ES performance)
+        context.finishView();
     }
 }
 
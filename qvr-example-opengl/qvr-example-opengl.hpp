@@ -62,8 +62,6 @@ private:
     /* Static data for rendering. Here, these are OpenGL resources that are
      * initialized per process, so there is no need to serialize them for
      * multi-process rendering support. */
-    unsigned int _fbo;                // Framebuffer object to render into
-    unsigned int _fboDepthTex;        // Depth attachment for the FBO
     unsigned int _floorVao;           // Vertex array object for the floor
     unsigned int _floorIndices;       // Number of indices to render for the pl.
     Material     _floorMaterial;      // Material of the floor
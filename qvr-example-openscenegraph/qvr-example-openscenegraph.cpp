@@ -48,17 +48,6 @@ bool QVRExampleOSG::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // FBO
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
     // OSG
     // Since we always only have to deal with one OpenGL context, we set up
     // just one graphics window with a dummy size, and in render() resize and
@@ -71,18 +60,14 @@ bool QVRExampleOSG::initProcess(QVRProcess* /* p */)
 }
 
 void QVRExampleOSG::render(QVRWindow* /* w */,
-        const QVRRenderContext& context, const unsigned int* textures)
+        const QVRRenderContext& context, const unsigned int* /* textures */)
 {
     for (int view = 0; view < context.viewCount(); view++) {
         // Get view dimensions
         int width = context.textureSize(view).width();
         int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height,
-                0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
+        // Set up framebuffer object and view
+        context.bindView(view);
         // Set up OSG graphics window
         _graphicsWindow->resized(0, 0, width, height);
         // Set up OSG camera
@@ -92,6 +77,7 @@ void QVRExampleOSG::render(QVRWindow* /* w */,
         _viewer.getCamera()->setViewMatrix(osg::Matrix(V.constData()));
         // Render
         _viewer.frame();
+        context.finishView();
     }
 }
 
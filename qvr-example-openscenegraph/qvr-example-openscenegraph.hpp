@@ -43,8 +43,6 @@ private:
     osgViewer::Viewer _viewer;
     osg::ref_ptr<osgViewer::GraphicsWindowEmbedded> _graphicsWindow;
     // OpenGL objects
-    unsigned int _fbo;
-    unsigned int _fboDepthTex;
 
 public:
     bool wantExit() override;
@@ -57,17 +57,6 @@ bool QVRExampleVTK::initProcess(QVRProcess* /* p */)
     // Qt-based OpenGL function pointers
     initializeOpenGLFunctions();
 
-    // FBO
-    glGenFramebuffers(1, &_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-    glGenTextures(1, &_fboDepthTex);
-    glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 1, 1,
-            0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _fboDepthTex, 0);
-
     // VTK: Pipeline. This one is a shortened version of the Marching Cubes example.
     vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
     sphereSource->SetPhiResolution(20);
@@ -120,18 +109,14 @@ static void qMatrixToVtkMatrix(const QMatrix4x4& qM, double vtkM[16])
 }
 
 void QVRExampleVTK::render(QVRWindow* /* w */,
-        const QVRRenderContext& context, const unsigned int* textures)
+        const QVRRenderContext& context, const unsigned int* /* textures */)
 {
     for (int view = 0; view < context.viewCount(); view++) {
         // Get view dimensions
         int width = context.textureSize(view).width();
         int height = context.textureSize(view).height();
-        // Set up framebuffer object to render into
-        glBindTexture(GL_TEXTURE_2D, _fboDepthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height,
-                0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[view], 0);
+        // Set up framebuffer object and view
+        context.bindView(view);
         // Set up VTK render window
         _vtkRenderWindow->SetSize(width, height);
         // Set up VTK camera view and projection matrix
@@ -142,6 +127,7 @@ void QVRExampleVTK::render(QVRWindow* /* w */,
         _vtkCamera->SetViewTransformMatrix(vtkMatrix);
         // Render
         _vtkRenderWindow->Render();
+        context.finishView();
     }
 }
 
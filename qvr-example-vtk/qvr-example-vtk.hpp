@@ -46,8 +46,6 @@ private:
     vtkSmartPointer<vtkRenderWindow> _vtkRenderWindow;
     vtkSmartPointer<vtkExternalOpenGLCamera> _vtkCamera;
     // OpenGL objects
-    unsigned int _fbo;
-    unsigned int _fboDepthTex;
 
 public:
     bool wantExit() override;
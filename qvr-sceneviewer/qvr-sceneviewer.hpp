@@ -43,8 +43,6 @@ private:
     QMatrix4x4 _M;
     SceneViewer _sceneViewer;
     bool _wantExit;
-    unsigned int _fbo;
-    unsigned int _fboDepthTex;
 
 public:
     bool wantExit() override;